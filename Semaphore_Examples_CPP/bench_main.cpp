@@ -0,0 +1,327 @@
+#include "include/introduction.h"
+#include "include/basic_sycnhronization_patterns.h"
+#include "include/classical_synchronization_problems.h"
+#include "include/less_classical_synchronization_problems.h"
+#include "include/not_so_classical_problems.h"
+#include "include/not_remotely_classical_problems.h"
+#include "include/scenario_runtime.h"
+#include "include/InstrumentedSync.h"
+#include "include/WaitForGraph.h"
+
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <poll.h>
+#include <signal.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+/*
+ - WHAT IS THIS !!
+    Semaphore_Examples_Bench runs the scenarios of the other headers one after another, each for a fixed wall time,
+    with the sleeps turned off (scenario_runtime::pause) and logging compiled out (LOGGING_ENABLED=0).
+    A "step" is one action of a scenario, i.e. one of its LOG lines (see scenario_runtime.h).
+
+    For every scenario it reports :
+        steps/s            : steps of all threads per second
+        step p50 / p99 (ns)    : time between two steps of the same thread. Sleeps are off, so this is mostly the
+                                 time a thread spends blocked between two of its actions.
+        acquire p50 / p99 (ns) : time from a call of scenario_runtime::acquire(semaphore, token) until the semaphore
+                                 is ours, every cancellable wait of the scenarios goes through it. Waits given up at
+                                 the stop are not counted. 0 for scenarios which never wait there.
+        voluntary / involuntary context switches of the whole scenario (getrusage)
+
+    Built with -DSYNC_STATS=ON, every scenario also prints the acquires, contention, wait and hold times of its
+    Instrumented semaphores and mutexes (InstrumentedSync.h) to stderr, so stdout stays plain csv / json.
+
+    With --watchdog MS every child tracks its Tracked semaphores and mutexes (WaitForGraph.h) and prints the
+    wait-for graph to stderr when their threads form a deadlock cycle or have all been blocked for MS milliseconds.
+
+ - WHY A PROCESS PER SCENARIO !!
+    Most scenarios never return (infinite loops, or deadlocks on purpose). Every scenario runs in its own forked
+    child, which reports its numbers through a pipe and then simply exits, whatever the scenario threads do.
+    A crashed or stuck child does not stop the other scenarios. The globals of the scenarios are fresh in every
+    child too, because the parent never runs a scenario itself.
+
+ - USAGE !!
+    Semaphore_Examples_Bench [--duration-ms N] [--threads 1,2,4,...] [--format csv|json] [--filter text] [--sleeps]
+                             [--watchdog MS]
+
+    --threads only affects the scenarios with a worker pool (scenario_runtime::thread_count), every count is a
+    separate run. The other scenarios run once with their own thread count (threads column is 0).
+ */
+
+namespace
+{
+    struct Scenario
+    {
+        const char* name;
+        void (*run)();
+        bool scalable; // uses scenario_runtime::thread_count
+    };
+
+    const Scenario scenarios[] = {
+        {"serialization",                          [] { introduction::serialization::run(); },                                             false},
+        {"non_determinism",                        [] { introduction::non_determinism::run(); },                                           false},
+        {"concurrent_writes",                      [] { introduction::concurrent_writes::run(); },                                         false},
+        {"concurrent_updates",                     [] { introduction::concurrent_updates::run(); },                                        false},
+        {"signaling",                              [] { basic_synchronization_patterns::signaling::run(); },                               false},
+        {"rendezvous",                             [] { basic_synchronization_patterns::rendezvous::run(); },                              false},
+        {"rendezvous_deadlock",                    [] { basic_synchronization_patterns::rendezvous_deadlock::run(); },                     false},
+        {"mutex",                                  [] { basic_synchronization_patterns::mutex::run(); },                                   false},
+        {"multiplex",                              [] { basic_synchronization_patterns::multiplex::run(); },                               false},
+        {"barrier_deadlock",                       [] { basic_synchronization_patterns::barrier_deadlock::run(); },                        false},
+        {"barrier_solution",                       [] { basic_synchronization_patterns::barrier_solution::run(); },                        false},
+        {"barrier_deadlock_2",                     [] { basic_synchronization_patterns::barrier_deadlock_2::run(); },                      false},
+        {"reusable_barrier_deadlock",              [] { basic_synchronization_patterns::reusable_barrier_deadlock::run(); },               false},
+        {"reusable_barrier_deadlock_2",            [] { basic_synchronization_patterns::reusable_barrier_deadlock_2::run(); },             false},
+        {"reusable_barrier_solution",              [] { basic_synchronization_patterns::reusable_barrier_solution::run(); },               false},
+        {"preloaded_turnstile",                    [] { basic_synchronization_patterns::preloaded_turnstile::run(); },                     false},
+        {"barrier_object",                         [] { basic_synchronization_patterns::barrier_object::run(); },                          false},
+        {"leader_and_follower_queue",              [] { basic_synchronization_patterns::leader_and_follower_queue::run(); },               false},
+        {"producer_consumer_problem_infinite",     [] { classical_synchronization_problems::producer_consumer_problem_infinite::run(); },  true},
+        {"producer_consumer_problem_finite",       [] { classical_synchronization_problems::producer_consumer_problem_finite::run(); },    true},
+        {"readers_and_writers_problem",            [] { classical_synchronization_problems::readers_and_writers_problem::run(); },         false},
+        {"no_starve_mutex",                        [] { classical_synchronization_problems::no_starve_mutex::run(); },                     false},
+        {"dining_philosophers",                    [] { classical_synchronization_problems::dining_philosophers::run(); },                 false},
+        {"cigarette_smokers_deadlock",             [] { classical_synchronization_problems::cigarette_smokers_deadlock::run(); },          false},
+        {"cigarette_smokers_parnas_solution",      [] { classical_synchronization_problems::cigarette_smokers_parnas_solution::run(); },   false},
+        {"cigarette_smokers_generalized_solution", [] { classical_synchronization_problems::cigarette_smokers_generalized_solution::run(); }, false},
+        {"dining_savages_problem",                 [] { less_classical_synchronization_problems::dining_savages_problem::run(); },         true},
+        {"the_barbershop_problem",                 [] { less_classical_synchronization_problems::the_barbershop_problem::run(); },         false},
+        {"the_fifo_barbershop_problem",            [] { less_classical_synchronization_problems::the_fifo_barbershop_problem::run(); },    false},
+        {"hilzers_barbershop_problem",             [] { less_classical_synchronization_problems::hilzers_barbershop_problem::run(); },     false},
+        {"the_santa_claus_problem",                [] { less_classical_synchronization_problems::the_santa_claus_problem::run(); },        false},
+        {"building_H2O",                           [] { less_classical_synchronization_problems::building_H2O::run(); },                   false},
+        {"river_crossing_problem",                 [] { less_classical_synchronization_problems::river_crossing_problem::run(); },         false},
+        {"search_insert_delete_problem",           [] { not_so_classical_problems::search_insert_delete_problem::run(); },                 false},
+        {"unisex_bathroom_problem",                [] { not_so_classical_problems::unisex_bathroom_problem::run(); },                      true},
+        {"no_starve_unisex_bathroom_problem",      [] { not_so_classical_problems::no_starve_unisex_bathroom_problem::run(); },            true},
+        {"modus_hall_problem",                     [] { not_so_classical_problems::modus_hall_problem::run(); },                           false},
+        {"sushi_bar_problem_non_solution",         [] { not_remotely_classical_problems::sushi_bar_problem_non_solution::run(); },         false},
+        {"sushi_bar_problem_solution_1",           [] { not_remotely_classical_problems::sushi_bar_problem_solution_1::run(); },           false},
+        {"sushi_bar_problem_solution_2",           [] { not_remotely_classical_problems::sushi_bar_problem_solution_2::run(); },           false},
+        {"child_care_problem_non_solution",        [] { not_remotely_classical_problems::child_care_problem_non_solution::run(); },        false},
+        {"room_party_problem",                     [] { not_remotely_classical_problems::room_party_problem::run(); },                     false},
+        {"senate_bus_problem_solution1",           [] { not_remotely_classical_problems::senate_bus_problem_solution1::run(); },           false},
+        {"senate_bus_problem_solution2",           [] { not_remotely_classical_problems::senate_bus_problem_solution2::run(); },           false},
+        {"faneuil_hall_problem",                   [] { not_remotely_classical_problems::faneuil_hall_problem::run(); },                   false},
+        {"faneuil_hall_problem_puzzle_solution",   [] { not_remotely_classical_problems::faneuil_hall_problem_puzzle_solution::run(); },   false},
+        {"extended_faneuil_hall_problem",          [] { not_remotely_classical_problems::extended_faneuil_hall_problem::run(); },          false},
+        {"dining_hall_problem",                    [] { not_remotely_classical_problems::dining_hall_problem::run(); },                    false},
+        {"extended_dining_hall_problem",           [] { not_remotely_classical_problems::extended_dining_hall_problem::run(); },           false},
+    };
+
+    struct Options
+    {
+        int durationMs = 1000;
+        std::vector<int> threads{0};
+        bool json = false;
+        std::string filter;
+        bool sleeps = false;
+        int watchdogMs = 0; // stall threshold of the WaitForGraph watchdog, 0 : no tracking
+    };
+
+    // What a child writes into the pipe. Plain data, so it can be written and read with one call.
+    struct Report
+    {
+        double seconds;
+        uint64_t steps;
+        uint64_t stepP50Ns;
+        uint64_t stepP99Ns;
+        uint64_t acquireP50Ns;
+        uint64_t acquireP99Ns;
+        long voluntarySwitches;
+        long involuntarySwitches;
+        bool returned; // run() finished before the time was up
+    };
+
+    struct Result
+    {
+        const char* scenario;
+        int threads;
+        const char* status; // "ok", "returned", "crashed" or "timeout"
+        Report report;
+    };
+
+    [[noreturn]] void run_child(const Scenario& _scenario, const Options& _options, int _threads, int _pipe)
+    {
+        scenario_runtime::sleepsEnabled.store(_options.sleeps);
+        scenario_runtime::threadOverride.store(_threads);
+        if (_options.watchdogMs > 0)
+        {
+            const std::chrono::milliseconds threshold(_options.watchdogMs);
+            WaitForGraph::instance().start_watchdog({std::max(threshold / 4, std::chrono::milliseconds(1)), threshold, &std::cerr});
+        }
+
+        rusage before{};
+        getrusage(RUSAGE_SELF, &before);
+        const auto start = std::chrono::steady_clock::now();
+        const auto deadline = start + std::chrono::milliseconds(_options.durationMs);
+
+        std::atomic<bool> returned{false};
+        scenario_runtime::measuring.store(true);
+        std::thread([&] { _scenario.run(); returned.store(true); }).detach();
+
+        while (!returned.load() && std::chrono::steady_clock::now() < deadline)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        scenario_runtime::measuring.store(false);
+
+        Report report{};
+        report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        report.returned = returned.load();
+
+        const scenario_runtime::Statistics statistics = scenario_runtime::collect();
+        report.steps = statistics.steps;
+        report.stepP50Ns = statistics.stepP50Ns;
+        report.stepP99Ns = statistics.stepP99Ns;
+        report.acquireP50Ns = statistics.acquireP50Ns;
+        report.acquireP99Ns = statistics.acquireP99Ns;
+
+        rusage after{};
+        getrusage(RUSAGE_SELF, &after);
+        report.voluntarySwitches = after.ru_nvcsw - before.ru_nvcsw;
+        report.involuntarySwitches = after.ru_nivcsw - before.ru_nivcsw;
+
+        sync_stats::dump(std::cerr, _scenario.name);
+
+        [[maybe_unused]] const ssize_t written = write(_pipe, &report, sizeof(report));
+        _exit(0); // the scenario threads may still run or be blocked forever, do not wait for them
+    }
+
+    Result run_scenario(const Scenario& _scenario, const Options& _options, int _threads)
+    {
+        Result result{_scenario.name, _threads, "crashed", {}};
+
+        int fds[2];
+        if (pipe(fds) != 0) { std::perror("pipe"); std::exit(1); }
+
+        const pid_t child = fork();
+        if (child < 0) { std::perror("fork"); std::exit(1); }
+        if (child == 0)
+        {
+            close(fds[0]);
+            run_child(_scenario, _options, _threads, fds[1]);
+        }
+        close(fds[1]);
+
+        // The child reports right after the duration. Give it some slack, then it counts as stuck.
+        pollfd readable{fds[0], POLLIN, 0};
+        if (poll(&readable, 1, _options.durationMs + 5000) <= 0)
+        {
+            result.status = "timeout";
+            kill(child, SIGKILL);
+        }
+        else if (read(fds[0], &result.report, sizeof(Report)) == static_cast<ssize_t>(sizeof(Report)))
+        {
+            result.status = result.report.returned ? "returned" : "ok";
+        }
+
+        close(fds[0]);
+        waitpid(child, nullptr, 0);
+        return result;
+    }
+
+    std::vector<int> parse_threads(const char* _list)
+    {
+        std::vector<int> threads;
+        for (const char* cursor = _list; *cursor != '\0'; )
+        {
+            char* end = nullptr;
+            const long count = std::strtol(cursor, &end, 10);
+            if (end == cursor) { break; }
+            threads.push_back(static_cast<int>(count));
+            cursor = *end == ',' ? end + 1 : end;
+        }
+        return threads;
+    }
+
+    Options parse_options(int _argc, char** _argv)
+    {
+        Options options;
+        for (int i = 1; i < _argc; ++i)
+        {
+            const std::string argument = _argv[i];
+            const bool hasValue = i + 1 < _argc;
+
+            if (argument == "--duration-ms" && hasValue)  { options.durationMs = std::atoi(_argv[++i]); }
+            else if (argument == "--threads" && hasValue) { options.threads = parse_threads(_argv[++i]); }
+            else if (argument == "--format" && hasValue)  { options.json = std::string(_argv[++i]) == "json"; }
+            else if (argument == "--filter" && hasValue)  { options.filter = _argv[++i]; }
+            else if (argument == "--sleeps")              { options.sleeps = true; }
+            else if (argument == "--watchdog" && hasValue) { options.watchdogMs = std::atoi(_argv[++i]); }
+            else
+            {
+                std::fprintf(stderr, "usage: %s [--duration-ms N] [--threads 1,2,4] [--format csv|json] [--filter text] [--sleeps] [--watchdog MS]\n", _argv[0]);
+                std::exit(2);
+            }
+        }
+        return options;
+    }
+
+    void print_csv_header()
+    {
+        std::printf("scenario,threads,status,seconds,steps,steps_per_sec,step_p50_ns,step_p99_ns,acquire_p50_ns,acquire_p99_ns,"
+                    "voluntary_cs,involuntary_cs\n");
+    }
+
+    void print_csv(const Result& _result)
+    {
+        const Report& report = _result.report;
+        std::printf("%s,%d,%s,%.3f,%llu,%.0f,%llu,%llu,%llu,%llu,%ld,%ld\n",
+                    _result.scenario, _result.threads, _result.status, report.seconds,
+                    static_cast<unsigned long long>(report.steps), report.seconds > 0 ? report.steps / report.seconds : 0.0,
+                    static_cast<unsigned long long>(report.stepP50Ns), static_cast<unsigned long long>(report.stepP99Ns),
+                    static_cast<unsigned long long>(report.acquireP50Ns), static_cast<unsigned long long>(report.acquireP99Ns),
+                    report.voluntarySwitches, report.involuntarySwitches);
+    }
+
+    void print_json(const Result& _result, bool _first)
+    {
+        const Report& report = _result.report;
+        std::printf("%s\n  {\"scenario\": \"%s\", \"threads\": %d, \"status\": \"%s\", \"seconds\": %.3f, \"steps\": %llu, "
+                    "\"steps_per_sec\": %.0f, \"step_p50_ns\": %llu, \"step_p99_ns\": %llu, \"acquire_p50_ns\": %llu, "
+                    "\"acquire_p99_ns\": %llu, \"voluntary_cs\": %ld, \"involuntary_cs\": %ld}",
+                    _first ? "" : ",", _result.scenario, _result.threads, _result.status, report.seconds,
+                    static_cast<unsigned long long>(report.steps), report.seconds > 0 ? report.steps / report.seconds : 0.0,
+                    static_cast<unsigned long long>(report.stepP50Ns), static_cast<unsigned long long>(report.stepP99Ns),
+                    static_cast<unsigned long long>(report.acquireP50Ns), static_cast<unsigned long long>(report.acquireP99Ns),
+                    report.voluntarySwitches, report.involuntarySwitches);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const Options options = parse_options(argc, argv);
+
+    if (options.json) { std::printf("["); }
+    else { print_csv_header(); }
+    std::fflush(stdout);
+
+    bool first = true;
+    for (const Scenario& scenario : scenarios)
+    {
+        if (!options.filter.empty() && std::strstr(scenario.name, options.filter.c_str()) == nullptr) { continue; }
+
+        for (int threads : options.threads)
+        {
+            const Result result = run_scenario(scenario, options, scenario.scalable ? threads : 0);
+            if (options.json) { print_json(result, first); }
+            else { print_csv(result); }
+            std::fflush(stdout); // the next fork must not inherit buffered output
+            first = false;
+
+            if (!scenario.scalable) { break; }
+        }
+    }
+
+    if (options.json) { std::printf("\n]\n"); }
+    return 0;
+}
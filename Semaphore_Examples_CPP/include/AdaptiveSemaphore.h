@@ -0,0 +1,180 @@
+//
+// Created by agent on 10/17/2026.
+//
+
+#ifndef SEMAPHORE_EXAMPLES_CPP_ADAPTIVE_SEMAPHORE_H
+#define SEMAPHORE_EXAMPLES_CPP_ADAPTIVE_SEMAPHORE_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <cstddef>
+#include <semaphore>
+#include <thread>
+#include "spin_wait.h"
+
+/*
+ - WHY !!
+    std::counting_semaphore decides by itself how long it spins before it sleeps on a futex, and we cannot tune it.
+    A handoff between two running threads (rendezvous, signaling, a turnstile) is over in well under a microsecond,
+    but a sleep and a wake-up cost a few microseconds and two context switches. A waiter which spins a little
+    catches the release while it is still running. A waiter which spins while the releaser is far away only burns
+    the core.
+
+ - SPIN THEN PARK !!
+    acquire : tries to take a token, then spins with exponential backoff (1, 2, 4 ... maxBackoff pause instructions
+              between two tries) up to the spin budget. No token by then -> it parks : acquire() sleeps on the count
+              itself (atomic wait, a futex on Linux, like std::counting_semaphore), try_acquire_for / until sleep on
+              the "wakeups" std::counting_semaphore with a timeout, because an atomic wait has none.
+    release : adds the tokens with one atomic operation and wakes sleepers only if there are any.
+
+ - ADAPTIVE SPINNING !!
+    Every semaphore keeps a moving average of the pauses a waiter needed before it got a token by spinning. The
+    budget of the next waiter is minSpins + 2 * average, at most maxSpins. Handoffs which finish while spinning
+    keep the budget near their length, a waiter which had to park shrinks the average, so a semaphore whose
+    waits are long stops spinning. This is the rule of the adaptive mutexes of glibc.
+
+ - DROP-IN !!
+    acquire / try_acquire / try_acquire_for / try_acquire_until / release / max, like std::counting_semaphore, so
+    scenario_runtime::acquire(semaphore, token) works with it as well. The spin limits are the SpinTuning of the
+    constructor.
+
+ - PAY ATTENTION !!
+    The count is an int, so LeastMaxValue is at most INT_MAX.
+    Spinning only pays off when the releaser runs on another core, on a single core maxSpins is 0 and it never spins.
+ */
+
+struct SpinTuning
+{
+    int minSpins = 16;     // budget of a semaphore which never got a token by spinning
+    // pause instructions, a few microseconds. With one core the releaser cannot run while we spin.
+    int maxSpins = std::thread::hardware_concurrency() > 1 ? 4'000 : 0;
+    int maxBackoff = 64;   // pauses between two tries at most
+};
+
+template <std::ptrdiff_t LeastMaxValue = INT_MAX>
+class AdaptiveSemaphore
+{
+    static_assert(LeastMaxValue >= 0 && LeastMaxValue <= INT_MAX, "the count of AdaptiveSemaphore is an int");
+
+public:
+    explicit AdaptiveSemaphore(std::ptrdiff_t _desired, SpinTuning _tuning = {}) :
+            count(static_cast<int>(_desired)),
+            tuning(_tuning)
+    {
+    }
+
+    AdaptiveSemaphore(const AdaptiveSemaphore&) = delete;
+    AdaptiveSemaphore& operator=(const AdaptiveSemaphore&) = delete;
+
+    static constexpr std::ptrdiff_t max() noexcept { return LeastMaxValue; }
+
+    void release(std::ptrdiff_t _update = 1)
+    {
+        count.fetch_add(static_cast<int>(_update), std::memory_order_seq_cst);
+        // Pairs with the increments of the sleepers : either we see the sleeper or it sees the tokens.
+        if (parked.load(std::memory_order_seq_cst) > 0)
+        {
+            if (_update == 1) { count.notify_one(); }
+            else { count.notify_all(); }
+        }
+        const int timedSleepers = timedParked.load(std::memory_order_seq_cst);
+        if (timedSleepers > 0)
+        {
+            // A wake-up is a token, so a sleeper which has not reached its wait yet does not miss it.
+            wakeups.release(std::min<std::ptrdiff_t>(_update, timedSleepers));
+        }
+    }
+
+    bool try_acquire() noexcept
+    {
+        int current = count.load(std::memory_order_seq_cst); // a sleeper must not miss tokens released before it announced itself
+        while (current > 0)
+        {
+            if (count.compare_exchange_weak(current, current - 1, std::memory_order_acquire, std::memory_order_relaxed)) { return true; }
+        }
+        return false;
+    }
+
+    void acquire()
+    {
+        if (spin_acquire()) { return; }
+
+        parked.fetch_add(1, std::memory_order_seq_cst);
+        while (!try_acquire()) { count.wait(0, std::memory_order_seq_cst); }
+        parked.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    template <typename Rep, typename Period>
+    bool try_acquire_for(const std::chrono::duration<Rep, Period>& _timeout)
+    {
+        return try_acquire_until(std::chrono::steady_clock::now() + _timeout);
+    }
+
+    template <typename Clock, typename Duration>
+    bool try_acquire_until(const std::chrono::time_point<Clock, Duration>& _deadline)
+    {
+        if (spin_acquire()) { return true; }
+        const auto steadyDeadline = std::chrono::steady_clock::now()
+                                    + std::chrono::ceil<std::chrono::steady_clock::duration>(_deadline - Clock::now());
+        return park_until(steadyDeadline);
+    }
+
+    int spin_budget() const
+    {
+        return std::min(tuning.maxSpins, tuning.minSpins + 2 * averageSpins.load(std::memory_order_relaxed));
+    }
+
+private:
+    bool spin_acquire()
+    {
+        const int budget = spin_budget();
+        int spins = 0;
+        int backoff = 1;
+        while (!try_acquire())
+        {
+            if (spins >= budget)
+            {
+                const int average = averageSpins.load(std::memory_order_relaxed);
+                averageSpins.store(average - (average + 7) / 8, std::memory_order_relaxed);
+                return false;
+            }
+            for (int i = 0; i < backoff; ++i) { cpu_relax(); }
+            spins += backoff;
+            backoff = std::min(backoff * 2, tuning.maxBackoff);
+        }
+
+        // Racy on purpose : a lost update only makes the average a little less recent.
+        const int average = averageSpins.load(std::memory_order_relaxed);
+        averageSpins.store(average + (spins - average) / 8, std::memory_order_relaxed);
+        return true;
+    }
+
+    // A wake-up may be left over when its sleeper got a token without it. The next timed sleeper then wakes up once
+    // for nothing, finds no token and sleeps again.
+    bool park_until(std::chrono::steady_clock::time_point _deadline)
+    {
+        timedParked.fetch_add(1, std::memory_order_seq_cst);
+        bool acquired = try_acquire();
+        while (!acquired)
+        {
+            const bool wokenUp = wakeups.try_acquire_until(_deadline);
+            acquired = try_acquire();
+            if (!wokenUp) { break; }
+        }
+        timedParked.fetch_sub(1, std::memory_order_relaxed);
+        return acquired;
+    }
+
+    alignas(64) std::atomic<int> count;
+    std::atomic<int> parked{0};       // threads asleep in acquire(), release() skips the notification when there are none
+    std::atomic<int> timedParked{0};  // threads asleep in park_until(), release() skips the wake-up when there are none
+    std::atomic<int> averageSpins{0};
+    const SpinTuning tuning;
+    std::counting_semaphore<> wakeups{0}; // only for timed sleepers
+};
+
+using AdaptiveBinarySemaphore = AdaptiveSemaphore<1>;
+
+#endif //SEMAPHORE_EXAMPLES_CPP_ADAPTIVE_SEMAPHORE_H
@@ -6,19 +6,77 @@
 #define SEMAPHORE_EXAMPLES_CPP_BARRIER_H
 
 #include <semaphore>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include "WaitForGraph.h"
+
+/*
+ - BARRIER POLICIES !!
+    turnstile  : Book implementation. A mutex protects count and two preloaded turnstiles let the threads pass.
+                 Every crossing costs 2n semaphore acquires plus a mutex round-trip for each thread.
+    generation : Arrival counter and generation number packed into a single atomic word.
+                 An arrival is one fetch_add. The last thread bumps the generation and wakes everybody,
+                 the others spin for a short time and then sleep on the word (futex on Linux).
+    combining_tree : Arrivals are combined in a tree with fan-in 4. A thread only touches its leaf and,
+                     if it is the last one there, the parent above it, so an arrival costs O(log n) cache lines
+                     instead of all threads hammering one counter. The thread that completes the root opens the
+                     next generation. Each thread is bound to a leaf the first time it arrives, so this policy
+                     needs the same n threads on every crossing (a pool of workers, not a stream of new threads).
+                     A thread n + 1 aborts the program, in release builds too.
+    generation and combining_tree take at most 65535 threads (arrivedMask), the constructor aborts above that.
+
+ - WAIT-FOR GRAPH !!
+    A thread blocked in the barrier waits on "barrier" in WaitForGraph.h, whatever the policy, so a barrier which
+    never fills up (barrier_object) shows up as a stall when the watchdog is on.
+ */
+enum class EBarrierPolicy : uint8_t
+{
+    turnstile,
+    generation,
+    combining_tree
+};
 
 class Barrier {
 public:
-    explicit Barrier(int _n);
+    explicit Barrier(int _n, EBarrierPolicy _policy = EBarrierPolicy::turnstile);
     void phase1();
     void phase2();
     void wait();
 private:
+    void turnstile_phase1();
+    void turnstile_phase2();
+    void generation_arrive();
+    void tree_arrive();
+    void build_tree();
+    int tree_slot();
+    void await_generation_change(uint32_t _generation, int _shift);
+
+    struct alignas(64) TreeNode
+    {
+        std::atomic<int> arrived{0};
+        int expected = 0; // number of children (threads or nodes) which arrive here
+        int parent = -1;  // -1 for the root
+    };
+
+    // How many times a waiter checks the word before it goes to sleep.
+    static constexpr int spinCount = 128;
+    // Layout of the state word : [generation : 16 bits][arrived : 16 bits]
+    static constexpr uint32_t arrivedMask = 0xFFFF;
+    static constexpr int generationShift = 16;
+    static constexpr int treeRadix = 4;
+
     int n;
     int count;
+    EBarrierPolicy policy;
     [[maybe_unused]] std::binary_semaphore mutex;
     [[maybe_unused]] std::binary_semaphore turnstile;
     [[maybe_unused]] std::binary_semaphore turnstile2;
+    uint64_t id; // unique per barrier, used to cache the leaf slot of a thread
+    std::unique_ptr<TreeNode[]> tree;
+    std::atomic<int> registered; // hands out leaf slots for the combining tree
+    alignas(64) std::atomic<uint32_t> state; // generation word, shared by the generation and combining_tree policies
+    const WaitForGraph::Primitive graphNode{"barrier", false};
 };
 
 #endif //SEMAPHORE_EXAMPLES_CPP_BARRIER_H
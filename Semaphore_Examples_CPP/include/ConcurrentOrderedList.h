@@ -0,0 +1,84 @@
+//
+// Created by agent on 10/17/2026.
+//
+
+#ifndef SEMAPHORE_EXAMPLES_CPP_CONCURRENT_ORDERED_LIST_H
+#define SEMAPHORE_EXAMPLES_CPP_CONCURRENT_ORDERED_LIST_H
+
+#include <atomic>
+#include <climits>
+#include <mutex>
+
+/*
+ - DEFINITION !!
+    Sorted set of ints with lazy locking (Heller, Herlihy, Luchangco, Moir, Scherer, Shavit). Searchers, inserters
+    and deleters run at the same time, nobody takes a list-wide lock:
+
+    contains : walks the list without any lock and checks the mark of the node it stops at (wait-free).
+    insert   : walks without locks, locks only the two nodes around the new one (pred, curr), checks that they are
+               still neighbours and not removed (validate), then links the new node in.
+    remove   : same locking, first marks curr as removed (logical delete), then unlinks it (physical delete).
+               A searcher which is standing on curr at that moment still finds the rest of the list behind it.
+
+    The list is kept between two sentinels, INT_MIN and INT_MAX, so every value has a pred and a curr.
+
+ - PAY ATTENTION !!
+    A removed node may still be visited by a searcher, so it cannot be deleted right away. Every operation runs in
+    an EpochReclaimer::Guard and remove retires the node, it is freed after the grace period (EpochReclaimer.h).
+    INT_MIN and INT_MAX are the sentinels, they cannot be stored : contains, insert and remove return false for them
+    and never touch the sentinel nodes.
+ */
+
+class ConcurrentOrderedList
+{
+public:
+    ConcurrentOrderedList();
+    ~ConcurrentOrderedList();
+    ConcurrentOrderedList(const ConcurrentOrderedList&) = delete;
+    ConcurrentOrderedList& operator=(const ConcurrentOrderedList&) = delete;
+
+    bool contains(int _value) const;
+    bool insert(int _value); // false if the value is already in the list
+    bool remove(int _value); // false if the value is not in the list
+    int size() const { return count.load(std::memory_order_relaxed); }
+
+private:
+    // One byte lock, with a std::mutex a node would be 4 times bigger (64 instead of 16 bytes). Waiters sleep on the flag (futex on Linux).
+    class NodeLock
+    {
+    public:
+        void lock()
+        {
+            while (locked.test_and_set(std::memory_order_acquire)) { locked.wait(true, std::memory_order_relaxed); }
+        }
+
+        void unlock()
+        {
+            locked.clear(std::memory_order_release);
+            locked.notify_one();
+        }
+
+    private:
+        std::atomic_flag locked;
+    };
+
+    struct Node
+    {
+        explicit Node(int _value, Node* _next = nullptr) : value(_value), marked(false), next(_next) {}
+
+        const int value;
+        std::atomic<bool> marked; // removed from the set, unlinked right after
+        NodeLock lock;
+        std::atomic<Node*> next;
+    };
+
+    // pred and curr are neighbours, pred->value < _value <= curr->value
+    void find(int _value, Node*& _pred, Node*& _curr) const;
+    static bool validate(const Node* _pred, const Node* _curr);
+    static bool is_sentinel(int _value) { return _value == INT_MIN || _value == INT_MAX; }
+
+    Node* head;
+    std::atomic<int> count;
+};
+
+#endif //SEMAPHORE_EXAMPLES_CPP_CONCURRENT_ORDERED_LIST_H
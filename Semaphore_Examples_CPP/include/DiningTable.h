@@ -0,0 +1,152 @@
+//
+// Created by agent on 10/17/2026.
+//
+
+#ifndef SEMAPHORE_EXAMPLES_CPP_DINING_TABLE_H
+#define SEMAPHORE_EXAMPLES_CPP_DINING_TABLE_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <semaphore>
+#include <stop_token>
+
+/*
+ - WHY !!
+    dining_philosophers had 5 philosophers at compile time (an std::array of forks, "% 5" in right()) and picked its
+    solution with a preprocessor switch. DiningTable takes the number of philosophers and the strategy at runtime, so
+    the same scenario runs with 5 or 10'000 philosophers and every strategy can be measured on the same ring.
+
+ - STRATEGIES !!
+    footman      : the regular solution. A counting semaphore lets at most n - 1 philosophers reach for their forks,
+                   so at least one of them gets both. Every meal goes through the one footman semaphore.
+    tanenbaum    : every philosopher is thinking, hungry or eating. A hungry philosopher eats when none of its
+                   neighbours eats, put_forks lets the hungry neighbours eat. One mutex guards all states.
+    tanenbaum_lock_free : the same rules without the mutex, see LOCK-FREE TANENBAUM.
+    chandy_misra : the forks are passed between neighbours, no global state at all. A fork is dirty after a meal and
+                   clean when it is handed over. A hungry philosopher takes a dirty fork from a neighbour which does
+                   not eat, a clean fork stays with its holder until it has eaten, then it goes to the neighbour which
+                   asked for it. At the start every fork is dirty and lies at the lower numbered neighbour, so the
+                   "who waits for whom" graph has no cycle and it never gets one : no deadlock, and a philosopher
+                   which got a clean fork keeps it, so nobody starves.
+
+ - THREADS !!
+    get_forks(i) / put_forks(i) may be called by any thread, a thread may serve several philosophers one after the
+    other (the benchmark drives 10'000 philosophers with a pool). A philosopher must not be served by two threads at
+    the same time.
+
+ - STATISTICS !!
+    Meals and the longest hunger (from get_forks until the forks are ours) are counted per philosopher on its own
+    cache line and summed up on request.
+
+ - LOCK-FREE TANENBAUM !!
+    The decision "may philosopher i eat" only reads i and its two neighbours, but the mutex of tanenbaum makes every
+    philosopher of the ring wait for every other one. Here a philosopher eats while it holds the bits of its two
+    forks, so "no neighbour eats" is "both fork bits are clear". The fork bits and the hungry bits of 16 philosophers
+    are packed into one 32 bit word on its own cache line :
+
+        bits  0 .. 15 : fork i is in use (by philosopher i - 1 or i)
+        bits 16 .. 31 : philosopher i is hungry
+
+    hungry -> eating is one compare_exchange on that word : hungry bit set and both fork bits clear -> fork bits set,
+    hungry bit cleared. A philosopher tries it for itself in get_forks, and put_forks tries it for both neighbours
+    (Tanenbaum's test) and wakes the one it succeeded for. Both sides write first and read the other side afterwards
+    (sequentially consistent), so a hungry philosopher is either seen by its neighbour or sees the free forks itself.
+    Only the philosophers of one word and its two neighbours touch the same cache line.
+
+    The last philosopher of a word (and the last of the ring) has its right fork in the next word. It takes the left
+    fork (with the hungry bit) first and the right one second. If the right one is in use, it gives the left one
+    back and tries its left neighbour again, which may have missed the fork in the meantime.
+
+ - PAY ATTENTION !!
+    get_forks returns false when the token is stopped while waiting. The philosopher may keep forks (or the footman
+    token) then, the table is not meant to be used afterwards.
+ */
+
+enum class EDiningStrategy : uint8_t
+{
+    footman,
+    tanenbaum,
+    tanenbaum_lock_free,
+    chandy_misra
+};
+
+class DiningTable
+{
+public:
+    DiningTable(int _philosophers, EDiningStrategy _strategy);
+    DiningTable(const DiningTable&) = delete;
+    DiningTable& operator=(const DiningTable&) = delete;
+
+    bool get_forks(int _index, const std::stop_token& _token);
+    void put_forks(int _index);
+
+    int size() const { return n; }
+    EDiningStrategy strategy() const { return policy; }
+    uint64_t meals() const;
+    uint64_t max_hunger_nanoseconds() const;
+
+    // Forks : fork i lies between philosopher i and philosopher i + 1.
+    int left_fork(int _index) const { return _index; }
+    int right_fork(int _index) const { return _index + 1 == n ? 0 : _index + 1; }
+    int left_neighbour(int _index) const { return _index == 0 ? n - 1 : _index - 1; }
+    int right_neighbour(int _index) const { return _index + 1 == n ? 0 : _index + 1; }
+
+private:
+    enum class EState : uint8_t
+    {
+        thinking,
+        hungry,
+        eating
+    };
+
+    struct alignas(64) Philosopher
+    {
+        EState state = EState::thinking;       // tanenbaum : under tableMutex, chandy_misra : under both fork mutexes
+        std::counting_semaphore<> turn{0};     // released when the philosopher may (try to) eat
+        std::atomic<uint64_t> meals{0};
+        std::atomic<uint64_t> maxHungerNs{0};
+    };
+
+    struct alignas(64) StateWord
+    {
+        std::atomic<uint32_t> bits{0}; // tanenbaum_lock_free : fork bits and hungry bits of 16 philosophers
+    };
+
+    static constexpr int philosophersPerWord = 16;
+    static uint32_t fork_bit(int _fork) { return 1u << (_fork % philosophersPerWord); }
+    static uint32_t hungry_bit(int _index) { return 1u << (philosophersPerWord + _index % philosophersPerWord); }
+    std::atomic<uint32_t>& word_of(int _forkOrPhilosopher) { return stateWords[_forkOrPhilosopher / philosophersPerWord].bits; }
+
+    struct alignas(64) Fork
+    {
+        std::binary_semaphore sem{1}; // footman
+        std::mutex mutex;             // chandy_misra, guards the fields below
+        int owner = 0;
+        bool dirty = true;
+        bool requested = false;       // the other neighbour waits for it
+    };
+
+    bool footman_get_forks(int _index, const std::stop_token& _token);
+    void footman_put_forks(int _index);
+    bool tanenbaum_get_forks(int _index, const std::stop_token& _token);
+    void tanenbaum_put_forks(int _index);
+    void tanenbaum_test(int _index);
+    bool lock_free_get_forks(int _index, const std::stop_token& _token);
+    void lock_free_put_forks(int _index);
+    bool lock_free_try_eat(int _index);
+    void lock_free_test(int _index);
+    bool chandy_misra_get_forks(int _index, const std::stop_token& _token);
+    void chandy_misra_put_forks(int _index);
+
+    int n;
+    EDiningStrategy policy;
+    std::unique_ptr<Philosopher[]> philosophers;
+    std::unique_ptr<Fork[]> forks;
+    std::unique_ptr<StateWord[]> stateWords;
+    std::counting_semaphore<> footman;
+    std::mutex tableMutex; // tanenbaum
+};
+
+#endif //SEMAPHORE_EXAMPLES_CPP_DINING_TABLE_H
@@ -0,0 +1,98 @@
+//
+// Created by agent on 10/17/2026.
+//
+
+#ifndef SEMAPHORE_EXAMPLES_CPP_EPOCH_RECLAIMER_H
+#define SEMAPHORE_EXAMPLES_CPP_EPOCH_RECLAIMER_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+/*
+ - WHY !!
+    A deleter which unlinks a node from a shared structure cannot delete it right away : a searcher may have read
+    the pointer a moment earlier and still be standing on the node. With locks the deleter excludes the searchers
+    (no_searcher in the search-insert-delete problem), which makes every search wait for every delete.
+
+ - EPOCH BASED RECLAMATION !!
+    There is one global epoch counter. A thread which is about to read the structure pins the current epoch
+    (EpochReclaimer::Guard) and unpins it when it is done, it never waits for anybody. A node which is unlinked in
+    epoch e is retired, not deleted. The epoch moves from e to e + 1 only when every pinned thread has seen e, so
+    when the epoch is e + 2, every thread which could have seen the node has left its guard : that is the grace
+    period, and the node is deleted.
+
+    Retired nodes wait in a list of the retiring thread. Every "scanInterval" retires the thread tries to move the
+    epoch on and deletes what is old enough.
+
+ - PAY ATTENTION !!
+    A thread which stays in a guard forever stops the epoch, and retired memory grows until it leaves.
+    Pointers read inside a guard must not be used after the guard ends.
+ */
+
+class EpochReclaimer
+{
+public:
+    class Guard
+    {
+    public:
+        Guard();
+        ~Guard();
+        Guard(const Guard&) = delete;
+        Guard& operator=(const Guard&) = delete;
+    };
+
+    static EpochReclaimer& instance();
+
+    ~EpochReclaimer();
+    EpochReclaimer(const EpochReclaimer&) = delete;
+    EpochReclaimer& operator=(const EpochReclaimer&) = delete;
+
+    // _object must already be unreachable for threads which enter a guard from now on.
+    template <typename T>
+    void retire(T* _object)
+    {
+        retire(_object, [](void* _pointer) { delete static_cast<T*>(_pointer); });
+    }
+
+    void retire(void* _object, void (*_deleter)(void*));
+
+    uint64_t freed() const { return freedCount.load(std::memory_order_relaxed); }
+
+private:
+    static constexpr uint64_t quiescent = UINT64_MAX; // epoch of a thread which is not in a guard
+    static constexpr int scanInterval = 64;
+
+    struct Retired
+    {
+        uint64_t epoch;
+        void* object;
+        void (*deleter)(void*);
+    };
+
+    struct alignas(64) ThreadRecord
+    {
+        std::atomic<uint64_t> epoch{quiescent};
+        std::atomic<bool> inUse{true};
+        int depth = 0; // nested guards of the owner thread
+        int retiresSinceScan = 0;
+        std::vector<Retired> limbo;
+    };
+
+    struct RecordOwner; // thread_local handle which gives the record back when its thread exits
+
+    EpochReclaimer() = default;
+    ThreadRecord& thread_record();
+    bool try_advance();
+    void free_expired(ThreadRecord& _record);
+
+    alignas(64) std::atomic<uint64_t> globalEpoch{0};
+    std::atomic<uint64_t> freedCount{0};
+
+    std::mutex recordsMutex; // guards records (registration and scans, not the guards)
+    std::vector<std::unique_ptr<ThreadRecord>> records;
+};
+
+#endif //SEMAPHORE_EXAMPLES_CPP_EPOCH_RECLAIMER_H
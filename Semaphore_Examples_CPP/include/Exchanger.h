@@ -0,0 +1,246 @@
+//
+// Created by agent on 10/17/2026.
+//
+
+#ifndef SEMAPHORE_EXAMPLES_CPP_EXCHANGER_H
+#define SEMAPHORE_EXAMPLES_CPP_EXCHANGER_H
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <optional>
+#include <thread>
+#include <utility>
+#include "AdaptiveSemaphore.h"
+#include "fast_random.h"
+#include "spin_wait.h"
+
+/*
+ - WHY !!
+    leader_and_follower_queue paired a leader and a follower with a mutex, two counters and three semaphores. Every
+    pair took the mutex, woke the partner through its queue semaphore and met again on the rendezvous semaphore,
+    and the mutex was unlocked by the other thread of the pair. An exchanger does the pairing itself : two threads
+    arrive, each hands over a value and leaves with the value of the other.
+
+ - HOW IT WORKS !!
+    There is an array of slots (an elimination array). A thread which arrives
+
+    1. looks for a waiting offer it may pair with and takes it with one compare_exchange on its slot. It writes its
+       value into the offer and wakes its owner. Done.
+    2. Finds none : it puts its own offer (on its stack) into a free slot with one compare_exchange, looks once more
+       for a partner which published at the same time (else both would wait), then spins and finally parks on its
+       offer (atomic wait) until a partner took it.
+    3. Every slot holds an offer it cannot take : it sleeps until a slot is freed.
+
+    The threads start their search at a random slot, so arrivals spread over the array instead of all fighting
+    for the first slot.
+
+    A slot holds the address of the offer with its side in the two low bits. The offer lives on the stack of its
+    owner, which may leave and publish a new offer at the same address, so a searcher never reads the side through
+    the pointer : it reads it from the slot word, and the compare_exchange which takes the offer checks address and
+    side at once.
+
+ - SIDES !!
+    exchange(value, side) : "left" pairs only with "right" (leaders and followers), "any" pairs with everybody.
+
+ - PAY ATTENTION !!
+    exchange() blocks until a partner arrives, there is no timeout.
+    Slots are the waiting threads which can be seen at once. More waiters of one side than slots wait in step 3
+    until a partner frees a slot.
+    The spin limits are the SpinTuning of AdaptiveSemaphore.h, on a single core it parks right away.
+ */
+
+enum class EExchangeSide : uint8_t
+{
+    any,   // pairs with every side
+    left,  // pairs with right and any
+    right  // pairs with left and any
+};
+
+template <typename T, int Slots = 8>
+class Exchanger
+{
+    static_assert(Slots > 0, "an exchanger needs at least one slot");
+
+public:
+    explicit Exchanger(SpinTuning _tuning = {}) : tuning(_tuning) {}
+    Exchanger(const Exchanger&) = delete;
+    Exchanger& operator=(const Exchanger&) = delete;
+
+    // Blocks until a thread of a matching side arrives, hands it _value and returns its value.
+    T exchange(T _value, EExchangeSide _side = EExchangeSide::any)
+    {
+        Offer mine{std::move(_value), _side, std::nullopt};
+        const int start = thread_random().uniform_int(0, Slots - 1);
+        int backoff = 1;
+
+        while (true)
+        {
+            if (Offer* other = take(_side, start)) { return complete(*other, std::move(mine.value)); }
+
+            if (Slot* slot = publish(mine, start))
+            {
+                if (wait_for_partner(mine, *slot, start)) { return std::move(*mine.received); }
+
+                // We withdrew for a partner which may withdraw for us at the same time, do not retry in lockstep.
+                for (int i = thread_random().uniform_int(1, backoff); i > 0; --i) { cpu_relax(); }
+                backoff = std::min(backoff * 2, tuning.maxBackoff);
+                continue;
+            }
+
+            wait_for_free_slot(_side);
+        }
+    }
+
+private:
+    enum : int { waiting, matched, done };
+
+    struct Offer
+    {
+        T value;
+        EExchangeSide side;
+        std::optional<T> received;
+        std::atomic<int> state{waiting}; // done : the partner does not touch the offer anymore
+    };
+
+    static_assert(alignof(Offer) >= 4, "the side is kept in the two low bits of the offer address");
+
+    // [address of the offer | side], 0 : free slot
+    using Tagged = uintptr_t;
+    static constexpr Tagged sideMask = 3;
+
+    static Tagged tagged(Offer& _offer) { return reinterpret_cast<Tagged>(&_offer) | static_cast<Tagged>(_offer.side); }
+    static Offer* offer_of(Tagged _word) { return reinterpret_cast<Offer*>(_word & ~sideMask); }
+    static EExchangeSide side_of(Tagged _word) { return static_cast<EExchangeSide>(_word & sideMask); }
+
+    struct alignas(64) Slot
+    {
+        std::atomic<Tagged> offer{0};
+    };
+
+    static bool pairs(EExchangeSide _a, EExchangeSide _b)
+    {
+        return _a == EExchangeSide::any || _b == EExchangeSide::any || _a != _b;
+    }
+
+    // The slot is ours once the compare_exchange removed the offer, nobody else can pair with its owner. The side is
+    // part of the compared word, so a new offer of another side at the same address makes it fail.
+    Offer* take(EExchangeSide _side, int _start)
+    {
+        for (int i = 0; i < Slots; ++i)
+        {
+            Slot& slot = slots[(_start + i) % Slots];
+            Tagged other = slot.offer.load(std::memory_order_seq_cst);
+            if (other != 0 && pairs(side_of(other), _side)
+                && slot.offer.compare_exchange_strong(other, 0, std::memory_order_seq_cst))
+            {
+                slot_freed();
+                return offer_of(other);
+            }
+        }
+        return nullptr;
+    }
+
+    // The owner waits until "done", so the offer lives until our last access, the notification included.
+    static T complete(Offer& _other, T&& _value)
+    {
+        T result = std::move(_other.value);
+        _other.received.emplace(std::move(_value));
+        _other.state.store(matched, std::memory_order_release);
+        _other.state.notify_one();
+        _other.state.store(done, std::memory_order_release);
+        return result;
+    }
+
+    Slot* publish(Offer& _mine, int _start)
+    {
+        for (int i = 0; i < Slots; ++i)
+        {
+            Slot& slot = slots[(_start + i) % Slots];
+            Tagged empty = 0;
+            if (slot.offer.load(std::memory_order_relaxed) == 0
+                && slot.offer.compare_exchange_strong(empty, tagged(_mine), std::memory_order_seq_cst))
+            {
+                return &slot;
+            }
+        }
+        return nullptr;
+    }
+
+    // Returns false if it withdrew the offer because a partner is waiting in another slot.
+    bool wait_for_partner(Offer& _mine, Slot& _slot, int _start)
+    {
+        // Both publish and read seq_cst : of two partners which published at the same time, at least one sees the other.
+        if (partner_waiting(_mine, _start))
+        {
+            Tagged expected = tagged(_mine);
+            if (_slot.offer.compare_exchange_strong(expected, 0, std::memory_order_seq_cst))
+            {
+                slot_freed();
+                return false;
+            }
+            // Too late, a partner took our offer already.
+        }
+
+        int spins = 0;
+        int backoff = 1;
+        while (_mine.state.load(std::memory_order_acquire) == waiting && spins < tuning.maxSpins)
+        {
+            for (int i = 0; i < backoff; ++i) { cpu_relax(); }
+            spins += backoff;
+            backoff = std::min(backoff * 2, tuning.maxBackoff);
+        }
+        while (_mine.state.load(std::memory_order_acquire) == waiting) { _mine.state.wait(waiting, std::memory_order_acquire); }
+        // The partner is between its notification and "done", a few instructions unless it was preempted there.
+        for (int i = 0; _mine.state.load(std::memory_order_acquire) != done; ++i)
+        {
+            if (i < 64) { cpu_relax(); }
+            else { std::this_thread::yield(); }
+        }
+        return true;
+    }
+
+    bool partner_waiting(const Offer& _mine, int _start) const
+    {
+        for (int i = 0; i < Slots; ++i)
+        {
+            const Tagged other = slots[(_start + i) % Slots].offer.load(std::memory_order_seq_cst);
+            if (other != 0 && offer_of(other) != &_mine && pairs(side_of(other), _mine.side)) { return true; }
+        }
+        return false;
+    }
+
+    // Nothing to take and nowhere to wait : sleep until a slot is freed.
+    void wait_for_free_slot(EExchangeSide _side)
+    {
+        const uint32_t seen = freedSlots.load(std::memory_order_seq_cst);
+        slotWaiters.fetch_add(1, std::memory_order_seq_cst);
+        if (all_slots_blocked(_side)) { freedSlots.wait(seen, std::memory_order_seq_cst); }
+        slotWaiters.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    bool all_slots_blocked(EExchangeSide _side) const
+    {
+        for (const Slot& slot : slots)
+        {
+            const Tagged other = slot.offer.load(std::memory_order_seq_cst);
+            if (other == 0 || pairs(side_of(other), _side)) { return false; }
+        }
+        return true;
+    }
+
+    void slot_freed()
+    {
+        freedSlots.fetch_add(1, std::memory_order_seq_cst);
+        // Pairs with wait_for_free_slot : either we see the sleeper or it sees the free slot.
+        if (slotWaiters.load(std::memory_order_seq_cst) > 0) { freedSlots.notify_all(); }
+    }
+
+    std::array<Slot, Slots> slots;
+    alignas(64) std::atomic<uint32_t> freedSlots{0}; // bumped on every freed slot, the threads of step 3 sleep on it
+    std::atomic<int> slotWaiters{0};
+    const SpinTuning tuning;
+};
+
+#endif //SEMAPHORE_EXAMPLES_CPP_EXCHANGER_H
@@ -0,0 +1,268 @@
+//
+// Created by agent on 10/17/2026.
+//
+
+#ifndef SEMAPHORE_EXAMPLES_CPP_INSTRUMENTED_SYNC_H
+#define SEMAPHORE_EXAMPLES_CPP_INSTRUMENTED_SYNC_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <mutex>
+#include <ostream>
+#include <utility>
+#include <vector>
+#include "scenario_runtime.h"
+
+/*
+ - WHY !!
+    A scenario with many semaphores (sofa, customer1, payment ... of Hilzer's barbershop) shows its steps/s in the
+    benchmark harness, but not which semaphore the threads are waiting on. Instrumented<Primitive> wraps a semaphore
+    or a mutex, gives it a name and records per primitive :
+
+    acquires   : successful acquire / lock calls
+    contended  : the ones which did not get the primitive on their first try
+    wait       : time from the call until the primitive is ours, as an HDR histogram (scenario_runtime::LatencyHistogram)
+    hold       : time from the acquire until the next release / unlock of the same primitive. For a mutex (or a
+                 binary semaphore used as one) that is the critical section, for a signaling semaphore it is the
+                 time until the next signal.
+
+    sync_stats::dump(out, title) prints one line per primitive which was used, sync_stats::reset() clears the numbers.
+
+ - COMPILE TIME SWITCH !!
+    Compile with -DSYNC_STATS_ENABLED=1 to record (CMake : -DSYNC_STATS=ON, for Semaphore_Examples_Bench). Without
+    it Instrumented<Primitive> derives from Primitive and only drops the name, every call is the call of the
+    primitive itself and dump() prints nothing.
+
+ - PAY ATTENTION !!
+    A timed acquire which gives up (scenario_runtime::acquire polls the stop token) is not an acquire. Its time is
+    kept per thread and added to the wait of the next acquire of the same primitive, so a long wait in small
+    pieces is recorded as one long wait.
+    For a counting semaphore with several holders the hold time is the time between one acquire and the next
+    release, whichever holder releases.
+    The contention check is a try_acquire / try_lock before the real wait. For std::counting_semaphore that try
+    spins a little by itself (libstdc++), which adds to the wait of contended acquires while recording.
+ */
+
+#ifndef SYNC_STATS_ENABLED
+#define SYNC_STATS_ENABLED 0
+#endif
+
+namespace sync_stats
+{
+    struct PrimitiveStats
+    {
+        const char* name;
+        std::atomic<uint64_t> acquires{0};
+        std::atomic<uint64_t> contended{0};
+        scenario_runtime::LatencyHistogram wait;
+        scenario_runtime::LatencyHistogram hold;
+    };
+
+    // Every instrumented primitive registers its stats while it lives.
+    inline std::mutex registryMutex;
+    inline std::vector<PrimitiveStats*> registry;
+
+    inline void add(PrimitiveStats& _stats)
+    {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        registry.push_back(&_stats);
+    }
+
+    inline void remove(PrimitiveStats& _stats)
+    {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        registry.erase(std::remove(registry.begin(), registry.end(), &_stats), registry.end());
+    }
+
+    inline void reset()
+    {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        for (PrimitiveStats* stats : registry)
+        {
+            stats->acquires.store(0, std::memory_order_relaxed);
+            stats->contended.store(0, std::memory_order_relaxed);
+            stats->wait.reset();
+            stats->hold.reset();
+        }
+    }
+
+    // Every primitive which was acquired at least once. The globals of all scenarios live in every program, the
+    // ones of the other scenarios stay silent. Prints nothing when nothing was recorded (or SYNC_STATS_ENABLED is 0).
+    inline void dump(std::ostream& _out, const char* _title = nullptr)
+    {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        const bool anyAcquire = std::any_of(registry.begin(), registry.end(), [](const PrimitiveStats* _stats)
+        {
+            return _stats->acquires.load(std::memory_order_relaxed) > 0;
+        });
+        if (!anyAcquire) { return; }
+
+        if (_title) { _out << "# " << _title << std::endl; }
+
+        _out << std::left << std::setw(16) << "primitive" << std::right << std::setw(12) << "acquires"
+             << std::setw(11) << "contended" << std::setw(15) << "wait p50 (ns)" << std::setw(15) << "wait p99 (ns)"
+             << std::setw(15) << "hold p50 (ns)" << std::setw(15) << "hold p99 (ns)" << std::endl;
+        for (const PrimitiveStats* stats : registry)
+        {
+            if (stats->acquires.load(std::memory_order_relaxed) == 0) { continue; }
+            _out << std::left << std::setw(16) << stats->name << std::right
+                 << std::setw(12) << stats->acquires.load(std::memory_order_relaxed)
+                 << std::setw(11) << stats->contended.load(std::memory_order_relaxed)
+                 << std::setw(15) << stats->wait.percentile(50) << std::setw(15) << stats->wait.percentile(99)
+                 << std::setw(15) << stats->hold.percentile(50) << std::setw(15) << stats->hold.percentile(99) << std::endl;
+        }
+    }
+}
+
+#if SYNC_STATS_ENABLED
+
+template <typename Primitive>
+class Instrumented
+{
+public:
+    template <typename... Args>
+    explicit Instrumented(const char* _name, Args&&... _args) : primitive(std::forward<Args>(_args)...)
+    {
+        stats.name = _name;
+        sync_stats::add(stats);
+    }
+
+    ~Instrumented() { sync_stats::remove(stats); }
+    Instrumented(const Instrumented&) = delete;
+    Instrumented& operator=(const Instrumented&) = delete;
+
+    // SEMAPHORE
+    void acquire()
+    {
+        if (primitive.try_acquire()) { acquired(0); return; }
+
+        stats.contended.fetch_add(1, std::memory_order_relaxed);
+        const auto start = Clock::now();
+        primitive.acquire();
+        acquired(waited_since(start));
+    }
+
+    bool try_acquire()
+    {
+        if (!primitive.try_acquire()) { return false; }
+        acquired(0);
+        return true;
+    }
+
+    template <typename Rep, typename Period>
+    bool try_acquire_for(const std::chrono::duration<Rep, Period>& _timeout)
+    {
+        PendingWait& pending = pending_wait();
+        if (primitive.try_acquire())
+        {
+            acquired(pending.take(this));
+            return true;
+        }
+
+        if (pending.owner != this) { stats.contended.fetch_add(1, std::memory_order_relaxed); } // first try of this wait
+        const auto start = Clock::now();
+        const bool success = primitive.try_acquire_for(_timeout);
+        const uint64_t waited = waited_since(start) + pending.take(this);
+        if (success) { acquired(waited); }
+        else { pending = {this, waited}; } // the caller tries again, or gives up and the next wait starts over
+        return success;
+    }
+
+    void release(std::ptrdiff_t _update = 1)
+    {
+        released();
+        primitive.release(_update);
+    }
+
+    // MUTEX
+    void lock()
+    {
+        if (primitive.try_lock()) { acquired(0); return; }
+
+        stats.contended.fetch_add(1, std::memory_order_relaxed);
+        const auto start = Clock::now();
+        primitive.lock();
+        acquired(waited_since(start));
+    }
+
+    bool try_lock()
+    {
+        if (!primitive.try_lock()) { return false; }
+        acquired(0);
+        return true;
+    }
+
+    void unlock()
+    {
+        released();
+        primitive.unlock();
+    }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    // Time a thread already waited on "owner" in timed acquires which gave up.
+    struct PendingWait
+    {
+        const void* owner = nullptr;
+        uint64_t nanoseconds = 0;
+
+        uint64_t take(const void* _owner)
+        {
+            const uint64_t taken = owner == _owner ? nanoseconds : 0;
+            owner = nullptr;
+            nanoseconds = 0;
+            return taken;
+        }
+    };
+
+    static PendingWait& pending_wait()
+    {
+        thread_local PendingWait pending;
+        return pending;
+    }
+
+    static uint64_t now_ns()
+    {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count());
+    }
+
+    static uint64_t waited_since(Clock::time_point _start)
+    {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - _start).count());
+    }
+
+    void acquired(uint64_t _waitedNs)
+    {
+        stats.acquires.fetch_add(1, std::memory_order_relaxed);
+        stats.wait.record(_waitedNs);
+        acquiredAt.store(now_ns(), std::memory_order_relaxed);
+    }
+
+    void released()
+    {
+        const uint64_t since = acquiredAt.exchange(0, std::memory_order_relaxed);
+        if (since != 0) { stats.hold.record(now_ns() - since); }
+    }
+
+    Primitive primitive;
+    sync_stats::PrimitiveStats stats;
+    std::atomic<uint64_t> acquiredAt{0}; // 0 : no acquire since the last release
+};
+
+#else
+
+template <typename Primitive>
+class Instrumented : public Primitive
+{
+public:
+    template <typename... Args>
+    explicit Instrumented(const char*, Args&&... _args) : Primitive(std::forward<Args>(_args)...) {}
+};
+
+#endif
+
+#endif //SEMAPHORE_EXAMPLES_CPP_INSTRUMENTED_SYNC_H
@@ -0,0 +1,79 @@
+//
+// Created by agent on 10/17/2026.
+//
+
+#ifndef SEMAPHORE_EXAMPLES_CPP_INTRUSIVE_WAIT_QUEUE_H
+#define SEMAPHORE_EXAMPLES_CPP_INTRUSIVE_WAIT_QUEUE_H
+
+#include <cassert>
+#include <semaphore>
+
+/*
+ - WHY !!
+    the_fifo_barbershop_problem and hilzers_barbershop_problem made a new semaphore for every visit
+    (std::make_shared) and put it into a std::queue<std::shared_ptr<...>> : an allocation for the semaphore and its
+    reference count, atomic reference counting on every copy and the deque of std::queue growing and shrinking
+    under the mutex. But a customer waits in one place at a time, so one semaphore per thread is enough.
+
+ - HOW IT WORKS !!
+    A Node is a binary semaphore and a "next" pointer on its own cache line. Every thread has its own nodes
+    (this_thread_node(slot)), created at its first visit and reused for all the visits after it. The queue only
+    links the nodes : push and pop are two pointer writes, nothing is allocated, nothing is copied.
+
+        customer : queue.push(node) under the mutex, then waits on node.wakeup
+        barber   : Node& next = queue.pop() under the mutex, then next.wakeup.release()
+
+ - PAY ATTENTION !!
+    The queue is not thread safe, like the std::queue it replaces it is used under the mutex of the scenario.
+    A node is in one queue at a time. A thread which goes on to the next queue while a barber may still be inside
+    the release of its node (Hilzer's customer : queue1, then queue2) takes a slot per queue.
+    The wakeup semaphore is reused, so every release must have its acquire : a left over release wakes the next
+    visit too early.
+    Nodes are never freed. A barber may still release the node of a customer which has already left (stopped
+    scenario), so the node outlives its thread, and the next thread does not get it either. That is
+    nodesPerThread nodes for every thread which ever waited.
+ */
+
+class IntrusiveWaitQueue
+{
+public:
+    static constexpr int nodesPerThread = 2;
+
+    struct alignas(64) Node
+    {
+        std::binary_semaphore wakeup{0};
+        Node* next = nullptr;
+    };
+
+    // The reusable node _slot of the calling thread.
+    static Node& this_thread_node(int _slot = 0);
+
+    IntrusiveWaitQueue() = default;
+    IntrusiveWaitQueue(const IntrusiveWaitQueue&) = delete;
+    IntrusiveWaitQueue& operator=(const IntrusiveWaitQueue&) = delete;
+
+    void push(Node& _node)
+    {
+        _node.next = nullptr;
+        if (tail) { tail->next = &_node; }
+        else { head = &_node; }
+        tail = &_node;
+    }
+
+    Node& pop()
+    {
+        assert(head && "pop from an empty wait queue");
+        Node& front = *head;
+        head = front.next;
+        if (!head) { tail = nullptr; }
+        return front;
+    }
+
+    bool empty() const { return head == nullptr; }
+
+private:
+    Node* head = nullptr;
+    Node* tail = nullptr;
+};
+
+#endif //SEMAPHORE_EXAMPLES_CPP_INTRUSIVE_WAIT_QUEUE_H
@@ -0,0 +1,89 @@
+//
+// Created by agent on 10/17/2026.
+//
+
+#ifndef SEMAPHORE_EXAMPLES_CPP_JOIN_PATTERN_MATCHER_H
+#define SEMAPHORE_EXAMPLES_CPP_JOIN_PATTERN_MATCHER_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <semaphore>
+#include <stop_token>
+#include <vector>
+
+/*
+ - WHY !!
+    cigarette_smokers_generalized_solution matched three ingredients with three pushers, a counter per ingredient and
+    one mutex : every ingredient put on the table took the mutex and looked at all counters. The same shape, "wait
+    until one of each of these resources is there and take them all at once", comes back whenever a piece of work
+    is assembled from several parts. JoinPatternMatcher does it for up to 64 resource types and any number of
+    recipes, without a mutex.
+
+ - HOW IT WORKS !!
+    A recipe is a bitmask of resource types (bit r : one unit of resource r). Every resource type has an atomic
+    counter on its own cache line.
+
+    produce(r, n) : adds n to the counter of r, then wakes a waiter of every recipe which needs r.
+    try_consume(recipe) : takes one unit of every resource of the recipe, in ascending order, each with a
+                          compare_exchange "count -> count - 1 if count > 0". If one of them is empty, it gives back
+                          the units it took already (a produce, so their waiters get woken) and fails.
+    consume(recipe, token) : try_consume, otherwise registers as a waiter of the recipe, tries once more and sleeps
+                             on the semaphore of the recipe until a produce of one of its resources.
+
+    Producers and consumers only meet on the counters of the resources they touch and on the recipes of those
+    resources, so recipes with disjoint resources never wait for each other.
+
+ - PAY ATTENTION !!
+    Recipes are added before the matcher is used (add_recipe is not thread safe).
+    Two consumers which compete for the last units may both take a part and give it back, so under heavy shortage
+    a consume may try a few times before it sleeps. Nobody sleeps while its recipe can be served : the waiter
+    registers before its last try and every produce looks for waiters afterwards (sequentially consistent).
+    A waiter is woken per produce and recipe, not per complete recipe, it may wake up and go back to sleep.
+ */
+
+class JoinPatternMatcher
+{
+public:
+    using Mask = uint64_t;
+    static constexpr int maxResources = 64;
+
+    explicit JoinPatternMatcher(int _resourceTypes);
+    JoinPatternMatcher(const JoinPatternMatcher&) = delete;
+    JoinPatternMatcher& operator=(const JoinPatternMatcher&) = delete;
+
+    int add_recipe(Mask _resources); // returns the id of the recipe
+
+    void produce(int _resource, int64_t _count = 1);
+    bool try_consume(int _recipe);
+    bool consume(int _recipe, const std::stop_token& _token); // false : stopped while waiting
+
+    int resource_types() const { return resourceTypes; }
+    int64_t available(int _resource) const { return counters[_resource].count.load(std::memory_order_relaxed); }
+    static Mask mask_of(int _resource) { return Mask{1} << _resource; }
+
+private:
+    struct alignas(64) Counter
+    {
+        std::atomic<int64_t> count{0};
+    };
+
+    struct alignas(64) Recipe
+    {
+        explicit Recipe(Mask _resources) : resources(_resources) {}
+
+        const Mask resources;
+        std::atomic<int> waiters{0};
+        std::counting_semaphore<> wakeups{0};
+    };
+
+    bool take_one(int _resource);
+    void give_back(Mask _taken);
+
+    int resourceTypes;
+    std::unique_ptr<Counter[]> counters;
+    std::vector<std::unique_ptr<Recipe>> recipes;
+    std::vector<std::vector<Recipe*>> recipesOf; // recipesOf[r] : every recipe which needs resource r
+};
+
+#endif //SEMAPHORE_EXAMPLES_CPP_JOIN_PATTERN_MATCHER_H
@@ -0,0 +1,127 @@
+//
+// Created by agent on 10/17/2026.
+//
+
+#ifndef SEMAPHORE_EXAMPLES_CPP_LIGHTSWITCH_H
+#define SEMAPHORE_EXAMPLES_CPP_LIGHTSWITCH_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <semaphore>
+
+/*
+ - ANALOGY !!
+    Lightswitch, by analogy with the pattern where the first person into a room turns on the light (acquires the room)
+    and the last one out turns it off (releases the room).
+
+    The lock method ensures that only the first thread will acquire the room, and the last thread to leave will release it.
+    The room is anything with acquire/release (a semaphore) or lock/unlock (a mutex). It is bound at construction,
+    so every switch belongs to one room and lock() / unlock() do not take it as a parameter.
+
+ - FAST PATH !!
+    The book version takes the mutex of the switch on every lock and unlock, so threads which are neither the first
+    in nor the last out still wait for each other. Here the counter is atomic :
+
+    lock   : counter > 0  -> the room is already ours, one compare_exchange counter -> counter + 1 and we are in.
+    unlock : counter > 1  -> somebody stays in the room, one compare_exchange counter -> counter - 1 and we are out.
+
+    Only the 0 -> 1 and 1 -> 0 transitions take the mutex, acquire or release the room and change the counter under it.
+    The counter becomes 1 only after the room is acquired, so a fast arrival never gets in before the room is ours.
+
+ - SCOPED LIGHTSWITCH !!
+    ScopedLightswitch locks the switch in its constructor and unlocks it in its destructor, like std::lock_guard. An early
+    return (a stop request) or an exception leaves the room, the raw lock / unlock pairs had to unlock on every path.
+
+ - HOLD TIME !!
+    The room changes hands only on the 0 -> 1 and 1 -> 0 transitions, which already take the mutex, so the switch
+    measures how long its side held the room there (room_held_nanoseconds), the fast path does not read the clock.
+
+ - PAY ATTENTION !!
+    The first thread may wait for the room while it holds the mutex, so the next arrivals wait behind it on the mutex,
+    just like in the book version.
+ */
+
+template <typename Room = std::binary_semaphore>
+class Lightswitch
+{
+public:
+    explicit Lightswitch(Room& _room) : room(_room), counter(0) {}
+    Lightswitch(const Lightswitch&) = delete;
+    Lightswitch& operator=(const Lightswitch&) = delete;
+
+    void lock()
+    {
+        int current = counter.load(std::memory_order_relaxed);
+        while (current > 0)
+        {
+            if (counter.compare_exchange_weak(current, current + 1, std::memory_order_acquire, std::memory_order_relaxed)) { return; }
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (counter.load(std::memory_order_relaxed) == 0)
+        {
+            acquire_room();
+            heldSince = Clock::now();
+        }
+        counter.fetch_add(1, std::memory_order_release);
+    }
+
+    void unlock()
+    {
+        int current = counter.load(std::memory_order_relaxed);
+        while (current > 1)
+        {
+            if (counter.compare_exchange_weak(current, current - 1, std::memory_order_release, std::memory_order_relaxed)) { return; }
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (counter.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            const auto held = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - heldSince).count();
+            heldNanoseconds.fetch_add(static_cast<uint64_t>(held), std::memory_order_relaxed);
+            release_room();
+        }
+    }
+
+    // Total time the room was held by this switch, from the first in to the last out. Finished holds only.
+    uint64_t room_held_nanoseconds() const { return heldNanoseconds.load(std::memory_order_relaxed); }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    void acquire_room()
+    {
+        if constexpr (requires { room.acquire(); }) { room.acquire(); }
+        else { room.lock(); }
+    }
+
+    void release_room()
+    {
+        if constexpr (requires { room.release(); }) { room.release(); }
+        else { room.unlock(); }
+    }
+
+    Room& room;
+    std::atomic<int> counter; // keeps track of how many threads are in the room
+    std::mutex mutex;         // only for the first in and the last out
+    Clock::time_point heldSince; // written and read under mutex
+    std::atomic<uint64_t> heldNanoseconds{0};
+};
+
+// Holds the switch for its scope, every return path leaves the room.
+template <typename Room>
+class ScopedLightswitch
+{
+public:
+    explicit ScopedLightswitch(Lightswitch<Room>& _lightswitch) : lightswitch(_lightswitch) { lightswitch.lock(); }
+    ~ScopedLightswitch() { lightswitch.unlock(); }
+    ScopedLightswitch(const ScopedLightswitch&) = delete;
+    ScopedLightswitch& operator=(const ScopedLightswitch&) = delete;
+
+private:
+    Lightswitch<Room>& lightswitch;
+};
+
+#endif //SEMAPHORE_EXAMPLES_CPP_LIGHTSWITCH_H
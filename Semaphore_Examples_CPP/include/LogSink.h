@@ -0,0 +1,187 @@
+//
+// Created by agent on 10/17/2026.
+//
+
+#ifndef SEMAPHORE_EXAMPLES_CPP_LOG_SINK_H
+#define SEMAPHORE_EXAMPLES_CPP_LOG_SINK_H
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <charconv>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#include "scenario_runtime.h"
+
+/*
+ - WHY NOT std::cout !!
+    std::cout << ... << std::endl inside (or right next to) a critical section makes every thread wait for the
+    iostream lock and for the terminal, because std::endl flushes on every line. Then the examples measure the
+    terminal, not the synchronization.
+
+ - HOW IT WORKS !!
+    LOG(a << b << c) formats the line into a stack buffer (no heap, no lock) and pushes it into a ring which only
+    belongs to the calling thread. A background drain thread takes the lines out of all rings and writes them to
+    stdout in big chunks. Every line is stamped with the steady clock when it is finished, the lines of one ring are
+    in stamp order already, and the drain merges the rings : it always prints the head line with the smallest stamp.
+    No shared counter is written per line, and a thread which is preempted while it writes its line holds back
+    nobody : the lines of the others are printed, its line joins when it is published.
+    A thread only waits when its own ring is full, i.e. when it logs faster than the terminal can print.
+
+    The drain sleeps on an atomic word (futex on Linux) while every ring is empty, a writer wakes it when it
+    published a line and the drain said it is going to sleep.
+
+ - COMPILE TIME SWITCH !!
+    Compile with -DLOGGING_ENABLED=0 to drop logging entirely. LOG(...) then compiles to nothing (the arguments are
+    still type-checked, but never evaluated) and no drain thread is started.
+
+ - PAY ATTENTION !!
+    A line is cut after LogSink::lineCapacity characters.
+    Two threads which log at nearly the same time may come out in either order : a line which is published after
+    the drain has printed a later stamp is printed right away, not held back for order.
+ */
+
+#ifndef LOGGING_ENABLED
+#define LOGGING_ENABLED 1
+#endif
+
+class LogSink
+{
+public:
+    static constexpr size_t lineCapacity = 116;
+
+    struct Record
+    {
+        uint64_t stamp; // steady clock nanoseconds, taken when the line is finished
+        uint32_t length;
+        char text[lineCapacity];
+    };
+
+    static LogSink& instance();
+
+    ~LogSink();
+    LogSink(const LogSink&) = delete;
+    LogSink& operator=(const LogSink&) = delete;
+
+    void write(std::string_view _line);
+    // Blocks until every line written before the call is printed.
+    void flush();
+
+private:
+    static constexpr size_t ringCapacity = 1024; // lines per thread, power of two
+
+    // Single producer (the owner thread) / single consumer (the drain thread) ring.
+    struct ThreadRing
+    {
+        std::array<Record, ringCapacity> records;
+        alignas(64) std::atomic<uint64_t> head{0}; // next record to drain, written by the drain thread
+        alignas(64) std::atomic<uint64_t> tail{0}; // next free record, written by the owner thread
+        std::atomic<bool> retired{false};          // owner thread has exited
+    };
+
+    struct RingOwner; // thread_local handle which retires the ring when its thread exits
+
+    LogSink();
+    ThreadRing& thread_ring();
+    void drain_loop();
+    uint64_t drain_available(std::string& _out); // returns the number of lines appended to _out
+    std::vector<ThreadRing*> live_rings();
+    bool all_rings_empty();
+    void wake_drain();
+
+    std::atomic<uint64_t> printedLines{0};    // lines on stdout (after fflush), written by the drain thread only
+    std::atomic<bool> stopping{false};
+    alignas(64) std::atomic<bool> drainSleeping{false}; // read by every writer, written when the drain sleeps or wakes up
+    std::atomic<uint32_t> wakeups{0};                  // the drain sleeps on it
+
+    std::mutex ringsMutex; // guards rings and removedLines (registration / removal only, not the log path)
+    std::vector<std::unique_ptr<ThreadRing>> rings;
+    uint64_t removedLines = 0; // lines of the rings which were removed, all printed
+
+    std::mutex flushMutex;
+    std::condition_variable flushed;
+
+    std::thread drainThread;
+};
+
+/*
+ Builds one line on the stack. Integers and floating point numbers are written with std::to_chars, strings are
+ copied, std::thread::id is written the way std::ostream writes it. The id is formatted once per thread through a
+ std::ostringstream and kept in a thread_local buffer, so a line only copies its text.
+ */
+class LogLine
+{
+public:
+    LogLine& operator<<(std::string_view _text)
+    {
+        const size_t count = std::min(_text.size(), LogSink::lineCapacity - length);
+        _text.copy(buffer.data() + length, count);
+        length += count;
+        return *this;
+    }
+
+    LogLine& operator<<(const char* _text) { return *this << std::string_view(_text); }
+    LogLine& operator<<(const std::string& _text) { return *this << std::string_view(_text); }
+
+    LogLine& operator<<(char _character)
+    {
+        if (length < LogSink::lineCapacity) { buffer[length++] = _character; }
+        return *this;
+    }
+
+    LogLine& operator<<(bool _value) { return *this << (_value ? '1' : '0'); }
+
+    template <typename Number, std::enable_if_t<std::is_arithmetic_v<Number>, int> = 0>
+    LogLine& operator<<(Number _value)
+    {
+        // uint8_t / int8_t are numbers in the examples, not characters.
+        using Printed = std::conditional_t<sizeof(Number) == 1 && std::is_integral_v<Number>, int, Number>;
+        const auto result = std::to_chars(buffer.data() + length, buffer.data() + LogSink::lineCapacity, static_cast<Printed>(_value));
+        if (result.ec == std::errc()) { length = result.ptr - buffer.data(); }
+        return *this;
+    }
+
+    LogLine& operator<<(std::thread::id _id)
+    {
+        // Almost always the id of the calling thread, so the text of the last formatted id is kept.
+        thread_local std::thread::id formattedId;
+        thread_local std::string formattedText;
+        if (formattedText.empty() || formattedId != _id)
+        {
+            std::ostringstream stream;
+            stream << _id;
+            formattedId = _id;
+            formattedText = stream.str();
+        }
+        return *this << std::string_view(formattedText);
+    }
+
+    void commit()
+    {
+#if LOGGING_ENABLED
+        LogSink::instance().write(std::string_view(buffer.data(), length));
+#endif
+    }
+
+private:
+    std::array<char, LogSink::lineCapacity> buffer;
+    size_t length = 0;
+};
+
+// LOG(a << b << c) : the line of std::cout << a << b << c << std::endl, without the lock and the flush.
+// Every line is also one step of the scenario for the benchmark harness (see scenario_runtime.h).
+#if LOGGING_ENABLED
+#define LOG(_message) do { scenario_runtime::step(); LogLine logLine; logLine << _message; logLine.commit(); } while (false)
+#else
+#define LOG(_message) do { scenario_runtime::step(); if (false) { LogLine logLine; logLine << _message; } } while (false)
+#endif
+
+#endif //SEMAPHORE_EXAMPLES_CPP_LOG_SINK_H
@@ -0,0 +1,212 @@
+//
+// Created by agent on 10/17/2026.
+//
+
+#ifndef SEMAPHORE_EXAMPLES_CPP_MPMC_RING_BUFFER_H
+#define SEMAPHORE_EXAMPLES_CPP_MPMC_RING_BUFFER_H
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+/*
+ - DEFINITION !!
+    Bounded multi-producer / multi-consumer queue of Dmitry Vyukov. The buffer is a fixed array of cells and
+    every cell carries its own sequence number, so producers and consumers never share a lock:
+
+        sequence == position       -> cell is free for the producer which claims "position"
+        sequence == position + 1   -> cell holds an item for the consumer which claims "position"
+
+    A producer claims a position with one CAS on enqueuePosition, writes the item and publishes it by storing
+    position + 1 into the cell. A consumer claims a position with one CAS on dequeuePosition, moves the item out
+    and frees the cell for the next lap by storing position + capacity.
+
+ - WHY CACHE-LINE PADDING !!
+    Both positions and every cell live on their own cache line. Otherwise producers and consumers that touch
+    neighbour cells (or the two positions) would invalidate each other's cache lines all the time (false sharing).
+
+ - PAY ATTENTION !!
+    try_push / try_pop never block. They return false when the buffer looks full / empty. Blocking is the job of
+    the caller, e.g. the items / space semaphores of the producer-consumer problem.
+ */
+
+template <typename T>
+class MPMCRingBuffer
+{
+public:
+    explicit MPMCRingBuffer(size_t _capacity) :
+            mask(round_up_to_power_of_two(_capacity) - 1),
+            cells(std::make_unique<Cell[]>(mask + 1)),
+            enqueuePosition(0),
+            dequeuePosition(0)
+    {
+        for (size_t i = 0; i <= mask; ++i) { cells[i].sequence.store(i, std::memory_order_relaxed); }
+    }
+
+    MPMCRingBuffer(const MPMCRingBuffer&) = delete;
+    MPMCRingBuffer& operator=(const MPMCRingBuffer&) = delete;
+
+    template <typename U>
+    bool try_push(U&& _item)
+    {
+        size_t position = enqueuePosition.load(std::memory_order_relaxed);
+
+        while (true)
+        {
+            Cell& cell = cells[position & mask];
+            const size_t sequence = cell.sequence.load(std::memory_order_acquire);
+            const auto difference = static_cast<std::ptrdiff_t>(sequence - position);
+
+            if (difference == 0)
+            {
+                // The cell is free for this lap, try to claim the position.
+                if (enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                {
+                    cell.data = std::forward<U>(_item);
+                    cell.sequence.store(position + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (difference < 0)
+            {
+                return false; // the consumer of the previous lap has not freed the cell yet : full
+            }
+            else
+            {
+                position = enqueuePosition.load(std::memory_order_relaxed); // another producer was faster
+            }
+        }
+    }
+
+    bool try_pop(T& _item)
+    {
+        size_t position = dequeuePosition.load(std::memory_order_relaxed);
+
+        while (true)
+        {
+            Cell& cell = cells[position & mask];
+            const size_t sequence = cell.sequence.load(std::memory_order_acquire);
+            const auto difference = static_cast<std::ptrdiff_t>(sequence - (position + 1));
+
+            if (difference == 0)
+            {
+                if (dequeuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                {
+                    _item = std::move(cell.data);
+                    cell.sequence.store(position + mask + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (difference < 0)
+            {
+                return false; // the producer of this position has not published yet : empty
+            }
+            else
+            {
+                position = dequeuePosition.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /*
+     Bulk versions claim up to _count neighbour positions with a single CAS. Before the CAS we only look at the
+     cells : a cell which is free (or published) for its position cannot change until somebody claims that
+     position, and nobody can claim it while our CAS on the shared position succeeds. They return how many items
+     were moved, which can be less than _count (or 0) when the buffer is nearly full / empty.
+     */
+    size_t try_push_bulk(T* _items, size_t _count)
+    {
+        size_t position = enqueuePosition.load(std::memory_order_relaxed);
+
+        while (true)
+        {
+            size_t available = 0;
+            std::ptrdiff_t difference = 0;
+            while (available < _count)
+            {
+                const size_t sequence = cells[(position + available) & mask].sequence.load(std::memory_order_acquire);
+                difference = static_cast<std::ptrdiff_t>(sequence - (position + available));
+                if (difference != 0) { break; }
+                ++available;
+            }
+
+            if (available == 0)
+            {
+                if (difference < 0 || _count == 0) { return 0; } // full
+                position = enqueuePosition.load(std::memory_order_relaxed);
+                continue;
+            }
+
+            if (enqueuePosition.compare_exchange_weak(position, position + available, std::memory_order_relaxed))
+            {
+                for (size_t i = 0; i < available; ++i)
+                {
+                    Cell& cell = cells[(position + i) & mask];
+                    cell.data = std::move(_items[i]);
+                    cell.sequence.store(position + i + 1, std::memory_order_release);
+                }
+                return available;
+            }
+        }
+    }
+
+    size_t try_pop_bulk(T* _items, size_t _count)
+    {
+        size_t position = dequeuePosition.load(std::memory_order_relaxed);
+
+        while (true)
+        {
+            size_t available = 0;
+            std::ptrdiff_t difference = 0;
+            while (available < _count)
+            {
+                const size_t sequence = cells[(position + available) & mask].sequence.load(std::memory_order_acquire);
+                difference = static_cast<std::ptrdiff_t>(sequence - (position + available + 1));
+                if (difference != 0) { break; }
+                ++available;
+            }
+
+            if (available == 0)
+            {
+                if (difference < 0 || _count == 0) { return 0; } // empty
+                position = dequeuePosition.load(std::memory_order_relaxed);
+                continue;
+            }
+
+            if (dequeuePosition.compare_exchange_weak(position, position + available, std::memory_order_relaxed))
+            {
+                for (size_t i = 0; i < available; ++i)
+                {
+                    Cell& cell = cells[(position + i) & mask];
+                    _items[i] = std::move(cell.data);
+                    cell.sequence.store(position + i + mask + 1, std::memory_order_release);
+                }
+                return available;
+            }
+        }
+    }
+
+    size_t capacity() const { return mask + 1; }
+
+private:
+    struct alignas(64) Cell
+    {
+        std::atomic<size_t> sequence;
+        T data;
+    };
+
+    static size_t round_up_to_power_of_two(size_t _value)
+    {
+        size_t result = 2; // the algorithm needs at least two cells
+        while (result < _value) { result <<= 1; }
+        return result;
+    }
+
+    const size_t mask;
+    std::unique_ptr<Cell[]> cells;
+    alignas(64) std::atomic<size_t> enqueuePosition;
+    alignas(64) std::atomic<size_t> dequeuePosition;
+};
+
+#endif //SEMAPHORE_EXAMPLES_CPP_MPMC_RING_BUFFER_H
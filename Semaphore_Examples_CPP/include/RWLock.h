@@ -0,0 +1,275 @@
+//
+// Created by agent on 10/17/2026.
+//
+
+#ifndef SEMAPHORE_EXAMPLES_CPP_RW_LOCK_H
+#define SEMAPHORE_EXAMPLES_CPP_RW_LOCK_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <semaphore>
+#include "Lightswitch.h"
+#include "StripedRWLock.h"
+
+/*
+ - RW LOCK POLICIES !!
+    Every policy answers the same question differently : who goes first when readers and writers wait at the same time ?
+
+    reader_priority : Lightswitch + roomEmpty. A reader gets in whenever another reader is in the room,
+                      so a steady stream of readers starves the writers.
+    turnstile       : The no-starve solution of the book. A writer locks the turnstile while it waits for the room,
+                      readers which arrive after it queue up behind it.
+    writer_priority : The writer-priority solution of the book. The first waiting writer locks noReaders, new readers
+                      wait until no writer is waiting any more, so a steady stream of writers starves the readers.
+    fair_phase      : Phase-fair. Reading phases and writing phases alternate : a reader which arrives while a writer
+                      is in or waiting gets in right after the next writer, even if more writers wait. A writer waits
+                      for at most one reading phase.
+    task_fair       : Strict FIFO. Every reader and writer takes a ticket and they get in in ticket order,
+                      readers with neighbour tickets share the room.
+    striped         : StripedRWLock. Readers are counted per core and writers have priority.
+
+ - WHY A TEMPLATE !!
+    RWLock<policy> is one class per policy with the same lock_shared / unlock_shared / lock / unlock interface, so the
+    scenario and the benchmark pick the policy at runtime (rw_lock_dispatch) but every lock call is a direct call.
+
+ - PAY ATTENTION !!
+    roomEmpty, noReaders and noWriters are semaphores, not mutexes, because the last reader out releases them,
+    which is usually not the thread which acquired them.
+ */
+
+enum class ERWLockPolicy : uint8_t
+{
+    reader_priority,
+    turnstile,
+    writer_priority,
+    fair_phase,
+    task_fair,
+    striped
+};
+
+constexpr ERWLockPolicy allRWLockPolicies[] = {
+    ERWLockPolicy::reader_priority,
+    ERWLockPolicy::turnstile,
+    ERWLockPolicy::writer_priority,
+    ERWLockPolicy::fair_phase,
+    ERWLockPolicy::task_fair,
+    ERWLockPolicy::striped
+};
+
+inline const char* rw_lock_policy_name(ERWLockPolicy _policy)
+{
+    switch (_policy)
+    {
+        case ERWLockPolicy::reader_priority: return "reader_priority";
+        case ERWLockPolicy::turnstile:       return "turnstile";
+        case ERWLockPolicy::writer_priority: return "writer_priority";
+        case ERWLockPolicy::fair_phase:      return "fair_phase";
+        case ERWLockPolicy::task_fair:       return "task_fair";
+        default:                             return "striped";
+    }
+}
+
+template <ERWLockPolicy Policy>
+class RWLock;
+
+template <>
+class RWLock<ERWLockPolicy::reader_priority>
+{
+public:
+    void lock_shared() { readSwitch.lock(); }
+    void unlock_shared() { readSwitch.unlock(); }
+    void lock() { roomEmpty.acquire(); }
+    void unlock() { roomEmpty.release(); }
+
+private:
+    std::binary_semaphore roomEmpty{1}; // 1 if there are no threads (readers or writers) in the critical section
+    Lightswitch<> readSwitch{roomEmpty};
+};
+
+template <>
+class RWLock<ERWLockPolicy::turnstile>
+{
+public:
+    void lock_shared()
+    {
+        turnstile.acquire();
+        turnstile.release();
+        readSwitch.lock();
+    }
+
+    void unlock_shared() { readSwitch.unlock(); }
+
+    void lock()
+    {
+        turnstile.acquire(); // readers which arrive from now on wait at the turnstile
+        roomEmpty.acquire();
+    }
+
+    void unlock()
+    {
+        turnstile.release();
+        roomEmpty.release();
+    }
+
+private:
+    std::binary_semaphore roomEmpty{1};
+    std::binary_semaphore turnstile{1};
+    Lightswitch<> readSwitch{roomEmpty};
+};
+
+template <>
+class RWLock<ERWLockPolicy::writer_priority>
+{
+public:
+    void lock_shared()
+    {
+        noReaders.acquire();
+        readSwitch.lock();
+        noReaders.release();
+    }
+
+    void unlock_shared() { readSwitch.unlock(); }
+
+    void lock()
+    {
+        writeSwitch.lock(); // the first writer keeps new readers out until the last writer leaves
+        noWriters.acquire();
+    }
+
+    void unlock()
+    {
+        noWriters.release();
+        writeSwitch.unlock();
+    }
+
+private:
+    std::binary_semaphore noReaders{1};
+    std::binary_semaphore noWriters{1};
+    Lightswitch<> readSwitch{noWriters};
+    Lightswitch<> writeSwitch{noReaders};
+};
+
+template <>
+class RWLock<ERWLockPolicy::fair_phase>
+{
+    /*
+     A writer which leaves lets in every reader which waited during its phase (it counts them into "readers" itself),
+     so the next writer has to wait for them even if it was waiting before them.
+     */
+public:
+    void lock_shared()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        if (!writer && waitingWriters == 0)
+        {
+            readers++;
+            return;
+        }
+
+        waitingReaders++;
+        const uint64_t phase = writePhases;
+        changed.wait(lock, [&] { return writePhases != phase; }); // the writer which ends the phase counted us in
+    }
+
+    void unlock_shared()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        readers--;
+        if (readers == 0) { changed.notify_all(); }
+    }
+
+    void lock()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        waitingWriters++;
+        changed.wait(lock, [&] { return !writer && readers == 0; });
+        waitingWriters--;
+        writer = true;
+    }
+
+    void unlock()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        writer = false;
+        writePhases++;
+        readers += waitingReaders;
+        waitingReaders = 0;
+        changed.notify_all();
+    }
+
+private:
+    std::mutex mutex;
+    std::condition_variable changed;
+    int readers = 0;        // readers in the room, including the ones let in by the last writer
+    int waitingReaders = 0; // readers which wait for the current writing phase to end
+    int waitingWriters = 0;
+    bool writer = false;
+    uint64_t writePhases = 0; // number of finished writing phases
+};
+
+template <>
+class RWLock<ERWLockPolicy::task_fair>
+{
+public:
+    void lock_shared()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        const uint64_t ticket = nextTicket++;
+        changed.wait(lock, [&] { return serving == ticket; });
+        readers++;
+        serving++; // the next ticket may be a reader as well, it can share the room
+        changed.notify_all();
+    }
+
+    void unlock_shared()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        readers--;
+        if (readers == 0) { changed.notify_all(); }
+    }
+
+    void lock()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        const uint64_t ticket = nextTicket++;
+        changed.wait(lock, [&] { return serving == ticket && readers == 0; });
+        // serving stays at our ticket until unlock, so everybody behind us waits
+    }
+
+    void unlock()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        serving++;
+        changed.notify_all();
+    }
+
+private:
+    std::mutex mutex;
+    std::condition_variable changed;
+    uint64_t nextTicket = 0;
+    uint64_t serving = 0;
+    int readers = 0;
+};
+
+template <>
+class RWLock<ERWLockPolicy::striped> : public StripedRWLock
+{
+};
+
+// Calls _body(RWLock<policy>&) with a new lock of the policy chosen at runtime.
+template <typename Body>
+void rw_lock_dispatch(ERWLockPolicy _policy, Body&& _body)
+{
+    switch (_policy)
+    {
+        case ERWLockPolicy::reader_priority: { RWLock<ERWLockPolicy::reader_priority> lock; _body(lock); break; }
+        case ERWLockPolicy::turnstile:       { RWLock<ERWLockPolicy::turnstile> lock; _body(lock); break; }
+        case ERWLockPolicy::writer_priority: { RWLock<ERWLockPolicy::writer_priority> lock; _body(lock); break; }
+        case ERWLockPolicy::fair_phase:      { RWLock<ERWLockPolicy::fair_phase> lock; _body(lock); break; }
+        case ERWLockPolicy::task_fair:       { RWLock<ERWLockPolicy::task_fair> lock; _body(lock); break; }
+        default:                             { RWLock<ERWLockPolicy::striped> lock; _body(lock); break; }
+    }
+}
+
+#endif //SEMAPHORE_EXAMPLES_CPP_RW_LOCK_H
@@ -0,0 +1,84 @@
+//
+// Created by agent on 10/17/2026.
+//
+
+#ifndef SEMAPHORE_EXAMPLES_CPP_SHARDED_POT_H
+#define SEMAPHORE_EXAMPLES_CPP_SHARDED_POT_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <semaphore>
+#include <stop_token>
+
+/*
+ - WHY !!
+    In dining_savages_problem every savage takes the one mutex to decrement servings, and the savage which finds the
+    pot empty keeps the mutex while it waits for the cook : every other savage waits for the cook as well, and the
+    cook only starts cooking once the pot is empty. ShardedPot is the same kitchen without those two stalls.
+
+ - HOW IT WORKS !!
+    There are several pots, each with an atomic servings counter on its own cache line. A savage takes a serving
+    with a compare_exchange "servings -> servings - 1 if servings > 0" on its home pot (savage % pots), the other
+    pots are tried only when the home pot is empty.
+
+    The savage which takes a pot down to the low watermark orders a refill from the cook of that pot (pot % cooks).
+    The cook cooks while the savages still eat the last servings, and adds M servings to the pot when it is done.
+    A pot is at the watermark exactly once per refill (the counter moves by one), so every refill is ordered once.
+
+    Only when every pot is empty a savage sleeps, until a cook filled a pot. Nobody holds a lock while it waits.
+
+ - PAY ATTENTION !!
+    lowWatermark 0 is the book : the cook is woken by the savage which takes the last serving.
+    A refill lands on top of what is left in the pot, so a pot holds at most M + lowWatermark servings.
+    get_serving and next_order return -1 when the token is stopped while waiting.
+ */
+
+class ShardedPot
+{
+public:
+    ShardedPot(int _pots, int _cooks, int _servingsPerRefill, int _lowWatermark);
+    ShardedPot(const ShardedPot&) = delete;
+    ShardedPot& operator=(const ShardedPot&) = delete;
+
+    // Savages : returns the pot the serving came from.
+    int get_serving(int _savage, const std::stop_token& _token);
+
+    // Cooks : next_order blocks until a pot of the cook reached the watermark and returns it, refill fills it.
+    int next_order(int _cook, const std::stop_token& _token);
+    void refill(int _pot);
+
+    int pots() const { return potCount; }
+    int cooks() const { return cookCount; }
+    uint64_t refills() const { return refillCount.load(std::memory_order_relaxed); }
+    uint64_t empty_waits() const { return emptyWaits.load(std::memory_order_relaxed); } // savages which found every pot empty
+
+private:
+    struct alignas(64) Pot
+    {
+        std::atomic<int64_t> servings{0};
+        std::atomic<bool> ordered{false}; // the refill is ordered, its cook has not picked it up yet
+    };
+
+    struct alignas(64) Cook
+    {
+        std::counting_semaphore<> orders{0};
+    };
+
+    bool take_from(int _pot);
+    int take_from_any(int _home);
+
+    int potCount;
+    int cookCount;
+    int64_t servingsPerRefill;
+    int64_t lowWatermark;
+    std::unique_ptr<Pot[]> pot;
+    std::unique_ptr<Cook[]> cook;
+
+    alignas(64) std::atomic<int> hungry{0}; // savages sleeping on served
+    std::counting_semaphore<> served{0};
+    std::atomic<uint64_t> refillCount{0};
+    std::atomic<uint64_t> emptyWaits{0};
+};
+
+#endif //SEMAPHORE_EXAMPLES_CPP_SHARDED_POT_H
@@ -0,0 +1,65 @@
+//
+// Created by agent on 10/17/2026.
+//
+
+#ifndef SEMAPHORE_EXAMPLES_CPP_STRIPED_RW_LOCK_H
+#define SEMAPHORE_EXAMPLES_CPP_STRIPED_RW_LOCK_H
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+
+/*
+ - WHY NOT A LIGHTSWITCH !!
+    The Lightswitch of the readers-writers problem changes one shared counter on every lock and unlock of a reader,
+    even on its atomic fast path (Lightswitch.h). With many readers the cache line of that counter moves from core
+    to core on every read, so readers which never conflict still wait for each other.
+
+ - DISTRIBUTED READER COUNT !!
+    Readers are counted on "stripes", one counter per cache line, about one stripe per core. A thread always uses
+    the same stripe, so readers on different cores write different cache lines and do not share anything but the
+    writer flag, which they only read.
+
+    reader : increments its stripe, then checks the writer flag. No writer -> it is in. Otherwise it takes its
+             increment back and sleeps until the writer leaves.
+    writer : takes the writer mutex (one writer at a time), raises the flag and waits until every stripe is 0.
+
+    Both sides write first and read the other side afterwards (sequentially consistent), so at least one of them
+    sees the other one : either the writer sees the reader on its stripe, or the reader sees the flag.
+
+ - PAY ATTENTION !!
+    A raised flag stops new readers, so a stream of writers can keep readers out (writer preference).
+    lock_shared / unlock_shared must be called by the same thread, the stripe belongs to the thread.
+ */
+
+class StripedRWLock
+{
+public:
+    StripedRWLock();
+    StripedRWLock(const StripedRWLock&) = delete;
+    StripedRWLock& operator=(const StripedRWLock&) = delete;
+
+    void lock_shared();
+    void unlock_shared();
+    void lock();
+    void unlock();
+
+private:
+    struct alignas(64) Stripe
+    {
+        std::atomic<int> readers{0};
+    };
+
+    static size_t stripe_index_of_this_thread();
+
+    // How many times a writer checks a stripe before it gives its time slice away.
+    static constexpr int spinCount = 64;
+
+    size_t mask;
+    std::unique_ptr<Stripe[]> stripes;
+    std::mutex writerMutex;
+    alignas(64) std::atomic<bool> writerActive;
+};
+
+#endif //SEMAPHORE_EXAMPLES_CPP_STRIPED_RW_LOCK_H
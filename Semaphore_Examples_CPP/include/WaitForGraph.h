@@ -0,0 +1,203 @@
+//
+// Created by agent on 10/17/2026.
+//
+
+#ifndef SEMAPHORE_EXAMPLES_CPP_WAIT_FOR_GRAPH_H
+#define SEMAPHORE_EXAMPLES_CPP_WAIT_FOR_GRAPH_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iosfwd>
+#include <mutex>
+#include <stop_token>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/*
+ - WHY !!
+    Several scenarios deadlock on purpose (rendezvous_deadlock, barrier_deadlock, cigarette_smokers_deadlock,
+    barrier_object ...), and a scenario under load may get stuck where it should not. From the outside both look
+    the same : no output. WaitForGraph keeps track of which thread waits on which primitive and
+    which thread holds it, and a watchdog thread reports what it sees :
+
+    deadlock cycle : thread A waits on a mutex held by B, B waits on a mutex held by A (any length).
+    global stall   : every tracked thread has been blocked for longer than the threshold. This also catches the
+                     deadlocks on semaphores, which have no owner (both threads of rendezvous_deadlock wait for a
+                     signal nobody will send).
+
+    The report is the wait-for graph : every tracked thread, what it waits on and for how long, what it holds.
+
+ - HOW IT WORKS !!
+    Every thread which touches a tracked primitive gets a record (registered on first use, removed when the thread
+    exits). Tracked<Primitive> writes into the record of the calling thread only : the primitive it blocks on and
+    since when, and the owned primitives (mutexes) it holds. A thread which gets a primitive without waiting does
+    not touch "waitingOn" at all. The watchdog reads all records every "period" under the registry mutex and
+    builds the graph, the threads never take that mutex after their registration.
+
+ - COST !!
+    Tracking is off until start_watchdog(). Then every call of Tracked<Primitive> is one relaxed load more, a
+    blocked call two relaxed stores before and one after the wait, a mutex two more for the held slots. Cheap
+    enough to leave on in load tests, unlike the histograms of InstrumentedSync.h.
+
+ - PAY ATTENTION !!
+    A timed wait which gives up (scenario_runtime::acquire polls the stop token) stays a wait : the thread is still
+    blocked on the same primitive, so its time adds up instead of starting over at every poll.
+    A thread holds at most "heldSlots" mutexes in the graph, more are not shown.
+    Livelock (threads which keep running without progress) is not a stall, they are not blocked.
+ */
+
+struct WatchdogOptions
+{
+    std::chrono::milliseconds period{100};
+    std::chrono::milliseconds stallThreshold{1000};
+    std::ostream* out = nullptr; // std::cerr when null
+};
+
+class WaitForGraph
+{
+public:
+    struct Primitive
+    {
+        const char* name;
+        bool owned; // released by the thread which acquired it (a mutex), so it has a holder in the graph
+    };
+
+    // Marks the calling thread as blocked on _primitive for its scope.
+    class Waiting
+    {
+    public:
+        explicit Waiting(const Primitive& _primitive) { if (enabled()) { instance().begin_wait(_primitive); } }
+        ~Waiting() { if (enabled()) { instance().end_wait(); } }
+        Waiting(const Waiting&) = delete;
+        Waiting& operator=(const Waiting&) = delete;
+    };
+
+    static WaitForGraph& instance();
+    static bool enabled() { return tracking.load(std::memory_order_relaxed); }
+
+    WaitForGraph(const WaitForGraph&) = delete;
+    WaitForGraph& operator=(const WaitForGraph&) = delete;
+
+    void set_thread_name(const char* _name);
+
+    void begin_wait(const Primitive& _primitive); // keeps the start time if the thread already waits on _primitive
+    void end_wait();
+    void acquired(const Primitive& _primitive);
+    void released(const Primitive& _primitive);
+
+    // Turns tracking on and starts the watchdog, which reports every new cycle or stall once.
+    void start_watchdog(WatchdogOptions _options = {});
+    void stop_watchdog(); // tracking stays on, the records stay valid
+
+    // One scan. Writes the report and returns true if there is a deadlock cycle or a global stall.
+    bool check(std::ostream& _out, std::chrono::milliseconds _stallThreshold);
+    void dump(std::ostream& _out);
+
+private:
+    static constexpr int heldSlots = 4;
+
+    struct ThreadRecord
+    {
+        int id = 0;
+        const char* name = nullptr;
+        std::atomic<const Primitive*> waitingOn{nullptr};
+        std::atomic<int64_t> waitingSince{0}; // steady_clock nanoseconds
+        std::array<std::atomic<const Primitive*>, heldSlots> held{};
+    };
+
+    struct RecordOwner; // thread_local handle which removes the record when its thread exits
+
+    WaitForGraph() = default;
+    ThreadRecord& thread_record();
+    void watch(std::stop_token _token, WatchdogOptions _options);
+
+    inline static std::atomic<bool> tracking{false};
+
+    std::mutex recordsMutex;
+    std::vector<ThreadRecord*> records;
+    int nextThreadId = 1;
+    std::jthread watchdog;
+};
+
+// A semaphore or a mutex which reports its waits (and for a mutex its holder) to WaitForGraph.
+template <typename Primitive>
+class Tracked
+{
+public:
+    template <typename... Args>
+    explicit Tracked(const char* _name, Args&&... _args) :
+            primitive(std::forward<Args>(_args)...),
+            node{_name, requires (Primitive& _p) { _p.lock(); }}
+    {
+    }
+
+    Tracked(const Tracked&) = delete;
+    Tracked& operator=(const Tracked&) = delete;
+
+    // SEMAPHORE
+    void acquire()
+    {
+        if (!WaitForGraph::enabled()) { primitive.acquire(); return; }
+
+        if (!primitive.try_acquire())
+        {
+            WaitForGraph::Waiting waiting(node);
+            primitive.acquire();
+        }
+        WaitForGraph::instance().end_wait(); // a timed wait which gave up before is over as well
+    }
+
+    bool try_acquire() { return primitive.try_acquire(); }
+
+    template <typename Rep, typename Period>
+    bool try_acquire_for(const std::chrono::duration<Rep, Period>& _timeout)
+    {
+        if (!WaitForGraph::enabled()) { return primitive.try_acquire_for(_timeout); }
+
+        WaitForGraph& graph = WaitForGraph::instance();
+        if (primitive.try_acquire()) { graph.end_wait(); return true; }
+
+        graph.begin_wait(node);
+        const bool success = primitive.try_acquire_for(_timeout);
+        if (success) { graph.end_wait(); } // on a timeout the thread keeps waiting, see PAY ATTENTION
+        return success;
+    }
+
+    void release(std::ptrdiff_t _update = 1) { primitive.release(_update); }
+
+    // MUTEX
+    void lock()
+    {
+        if (!WaitForGraph::enabled()) { primitive.lock(); return; }
+
+        WaitForGraph& graph = WaitForGraph::instance();
+        if (!primitive.try_lock())
+        {
+            WaitForGraph::Waiting waiting(node);
+            primitive.lock();
+        }
+        graph.acquired(node);
+    }
+
+    bool try_lock()
+    {
+        if (!primitive.try_lock()) { return false; }
+        if (WaitForGraph::enabled()) { WaitForGraph::instance().acquired(node); }
+        return true;
+    }
+
+    void unlock()
+    {
+        if (WaitForGraph::enabled()) { WaitForGraph::instance().released(node); }
+        primitive.unlock();
+    }
+
+private:
+    Primitive primitive;
+    const WaitForGraph::Primitive node;
+};
+
+#endif //SEMAPHORE_EXAMPLES_CPP_WAIT_FOR_GRAPH_H
@@ -0,0 +1,34 @@
+//
+// Created by agent on 10/17/2026.
+//
+
+#ifndef SEMAPHORE_EXAMPLES_CPP_ALLOCATION_COUNTER_H
+#define SEMAPHORE_EXAMPLES_CPP_ALLOCATION_COUNTER_H
+
+#include <cstdint>
+
+/*
+ - ALLOCATION COUNTING HOOK !!
+ When COUNT_ALLOCATIONS is 1, src/allocation_counter.cpp replaces the global operator new / delete of the program.
+ Every operator new call increments a counter of the calling thread, so a benchmark (or a test) can read the counter
+ before and after a piece of code and knows exactly how many heap allocations that thread made in between.
+ The counter is thread_local, so counting does not add any shared-cache-line traffic to the measured code.
+
+ Over-aligned allocations (operator new with std::align_val_t) are not counted.
+
+ - COMPILE TIME SWITCH !!
+ Off by default, so the program keeps the operator new / delete of the standard library. Configure with
+ -DCOUNT_ALLOCATIONS=ON (CMake option) to count, the benchmarks which report allocations need it.
+ */
+
+#ifndef COUNT_ALLOCATIONS
+#define COUNT_ALLOCATIONS 0
+#endif
+
+namespace allocation_counter
+{
+    // Number of operator new calls made by the calling thread so far (always 0 when counting is disabled).
+    uint64_t thread_allocations();
+}
+
+#endif //SEMAPHORE_EXAMPLES_CPP_ALLOCATION_COUNTER_H
@@ -7,14 +7,18 @@
 
 #include <semaphore>
 #include <barrier>
-#include <iostream>
 #include "Barrier.h"
+#include "AdaptiveSemaphore.h"
+#include "Exchanger.h"
+#include "WaitForGraph.h"
+#include "LogSink.h"
 
 namespace basic_synchronization_patterns
 {
     namespace signaling
     {
-        std::binary_semaphore binarySem(0); // A semaphore its max count 1, means just 1 thread can access.
+        // AdaptiveSemaphore.h : spins a little before it sleeps, so a handoff between two running threads skips the futex.
+        AdaptiveBinarySemaphore binarySem(0); // A semaphore its max count 1, means just 1 thread can access.
 
         /*
          In this implementation, the output should be the :
@@ -29,11 +33,11 @@ namespace basic_synchronization_patterns
         void threadB()
         {
             binarySem.acquire();
-            std::cout << "statement b1" << std::endl;
+            LOG("statement b1");
         }
         void threadA()
         {
-            std::cout << "statement a1" << std::endl;
+            LOG("statement a1");
             binarySem.release();
         }
 
@@ -70,8 +74,8 @@ namespace basic_synchronization_patterns
         As the names suggest, aArrived indicates whether Thread A has arrived at the rendezvous, and bArrived likewise.
         */
 
-        std::binary_semaphore aArrived(0); // A semaphore its max count 1, means just 1 thread can access.
-        std::binary_semaphore bArrived(0); // A semaphore its max count 1, means just 1 thread can access.
+        AdaptiveBinarySemaphore aArrived(0); // A semaphore its max count 1, means just 1 thread can access.
+        AdaptiveBinarySemaphore bArrived(0); // A semaphore its max count 1, means just 1 thread can access.
 
         /*
             REMINDING !!!
@@ -86,24 +90,24 @@ namespace basic_synchronization_patterns
          */
         void threadA()
         {
-            std::cout << "statement a1" << std::endl;
+            LOG("statement a1");
             // semaphore value is increased. Now value is 1 and it means available.
             aArrived.release();
             // semaphore value is decreased. But initially value is 0. So decreasing not valid.
             // Because value cannot be negative. So if bArrived is not released by threadB, threadA cannot move.
             bArrived.acquire();
-            std::cout << "statement a2" << std::endl;
+            LOG("statement a2");
         }
 
         void threadB()
         {
-            std::cout << "statement b1" << std::endl;
+            LOG("statement b1");
             // semaphore value is increased. Now value is 1 and it means available.
             bArrived.release();
             // semaphore value is decreased. But initially value is 0. So decreasing not valid.
             // Because value cannot be negative. So if aArrived is not released by threadA, threadB cannot move.
             aArrived.acquire();
-            std::cout << "statement b2" << std::endl;
+            LOG("statement b2");
         }
 
         void run()
@@ -134,25 +138,29 @@ namespace basic_synchronization_patterns
          No fully output. Because of  no signaling. Both threads are writing the first statements but not writing the second one.
          Becuase both threads call the acquire() first but not get in and call release() because of the semaphores initial value is 0
          and that causes the deadlocks.
+
+         - WAIT-FOR GRAPH !!
+         Semaphores have no owner, so there is no cycle to find. With the watchdog on (WaitForGraph.h) it reports a global
+         stall instead : both threads wait on 'aArrived' / 'bArrived' and nobody runs.
      */
 
-        std::binary_semaphore aArrived(0);
-        std::binary_semaphore bArrived(0);
+        Tracked<std::binary_semaphore> aArrived("aArrived", 0);
+        Tracked<std::binary_semaphore> bArrived("bArrived", 0);
 
         void runThreadA()
         {
-            std::cout << "statement a1" << std::endl;
+            LOG("statement a1");
             bArrived.acquire(); // Lock semaphore
             aArrived.release(); // Release semaphore
-            std::cout << "statement a2" << std::endl;
+            LOG("statement a2");
         }
 
         void runThreadB()
         {
-            std::cout << "statement b1" << std::endl;
+            LOG("statement b1");
             aArrived.acquire(); // Lock semaphore
             bArrived.release(); // Release semaphore
-            std::cout << "statement b2" << std::endl;
+            LOG("statement b2");
         }
 
         void run()
@@ -221,7 +229,7 @@ namespace basic_synchronization_patterns
             if (tA.joinable()) { tA.join(); }
             if (tB.joinable()) { tB.join(); }
 
-            std::cout << "Result : " << x << std::endl;
+            LOG("Result : " << x);
 
             return 0;
         }
@@ -256,7 +264,7 @@ namespace basic_synchronization_patterns
              Becuase "NO RELEASING".
              That proves the "threads the size of multiplex can run at the same time."
              Because when 4 thread get in the critical section, 5. thread has to wait.*/
-            std::cout << _no << ". thread is running...\n";
+            LOG(_no << ". thread is running...");
             // TODO : For correct solution uncomment this line.
             // multiplex.release();
         }
@@ -309,8 +317,8 @@ namespace basic_synchronization_patterns
 
         const uint8_t n = 5;
         int count = 0;
-        std::mutex mutex;
-        std::counting_semaphore<n> barrier(0);
+        Tracked<std::mutex> mutex("mutex");
+        Tracked<std::counting_semaphore<n>> barrier("barrier", 0);
         // std::barrier barrier_alternative(0);
 
         void execute()
@@ -383,7 +391,7 @@ namespace basic_synchronization_patterns
             // Alternative implementation with CPP barrier lib
             //barrier_alternative.arrive_and_wait();
 
-            std::cout << "Barrier reached to the end!" << std::endl;
+            LOG("Barrier reached to the end!");
         }
 
         void run()
@@ -412,13 +420,17 @@ namespace basic_synchronization_patterns
 
          - CODE OUTPUT !!
          NO OUTPUT because of the deadlock.
+
+         - WAIT-FOR GRAPH !!
+         The watchdog (WaitForGraph.h) shows it : one thread holds 'mutex' and waits on 'barrier', the other four wait on
+         'mutex'.
      */
 
 
         int n = 5;
         int count = 0;
-        std::mutex mutex;
-        std::binary_semaphore barrier(0);
+        Tracked<std::mutex> mutex("mutex");
+        Tracked<std::binary_semaphore> barrier("barrier", 0);
 
         void execute()
         {
@@ -428,13 +440,13 @@ namespace basic_synchronization_patterns
             if (count == n) { barrier.release(); }
 
             barrier.acquire();
-            // std::cout << "Acquired" << std::endl;
+            // LOG("Acquired");
             barrier.release();
-            // std::cout << "Released" << std::endl;
+            // LOG("Released");
 
             mutex.unlock(); // Increase the mutex value by 1
 
-            std::cout << "Barrier reached to the end!" << std::endl;
+            LOG("Barrier reached to the end!");
         }
 
         void run()
@@ -472,8 +484,8 @@ namespace basic_synchronization_patterns
 
         int n = 5;
         int count = 0;
-        std::mutex mutex;
-        std::binary_semaphore turnstile(0);
+        Tracked<std::mutex> mutex("mutex");
+        Tracked<std::binary_semaphore> turnstile("turnstile", 0);
 
         void execute()
         {
@@ -492,7 +504,7 @@ namespace basic_synchronization_patterns
 
             if (count == 0) { turnstile.acquire(); }
 
-            std::cout << "Reusable barrier reached to the end!" << std::endl;
+            LOG("Reusable barrier reached to the end!");
         }
 
         void run()
@@ -527,8 +539,8 @@ namespace basic_synchronization_patterns
 
         int n = 5;
         int count = 0;
-        std::mutex mutex;
-        std::binary_semaphore turnstile(0);
+        Tracked<std::mutex> mutex("mutex");
+        Tracked<std::binary_semaphore> turnstile("turnstile", 0);
 
         void execute()
         {
@@ -545,7 +557,7 @@ namespace basic_synchronization_patterns
             if (count == 0) { turnstile.acquire(); }
             mutex.unlock();
 
-            std::cout << "Reusable barrier reached to the end!" << std::endl;
+            LOG("Reusable barrier reached to the end!");
         }
 
         void run()
@@ -586,8 +598,8 @@ namespace basic_synchronization_patterns
         int n = 5;
         int count = 0;
         std::mutex mutex;
-        std::binary_semaphore turnstile(0);
-        std::binary_semaphore turnstile2(1);
+        AdaptiveBinarySemaphore turnstile(0);
+        AdaptiveBinarySemaphore turnstile2(1);
 
         void execute()
         {
@@ -615,7 +627,7 @@ namespace basic_synchronization_patterns
             turnstile2.acquire(); // Blocking for first thread
             turnstile2.release(); // When first thread released, then it releases the thread which comes after it.
 
-            std::cout << "Reusable barrier reached to the end!" << std::endl;
+            LOG("Reusable barrier reached to the end!");
         }
 
         void run()
@@ -675,7 +687,7 @@ namespace basic_synchronization_patterns
 
             turnstile2.acquire(); // Blocking for threads
 
-            std::cout << "Preloaded barrier reached to the end!" << std::endl;
+            LOG("Preloaded barrier reached to the end!");
         }
 
         void run()
@@ -708,73 +720,44 @@ namespace basic_synchronization_patterns
     {
         /*
          - LOGIC OF RUNNING !!
-         This code enables multithreading using mutex and semaphores to provide synchronization and matching between leaders and followers.
-         The goal of the code is to coordinate the pairing and dancing of leaders and followers and to ensure that both sides move in a synchronized manner.
+         Leaders and followers have to dance in pairs : one leader with one follower.
 
-         A leader checks if there are followers. If there are followers, the leader and follower match.
-         If there are no followers, it is added to the leaders queue and waits. A follower checks if there are leaders.
-         If there are leaders, the follower and leader match. If there is no leader, it is added to the followers queue and waits.
+         The book version pairs them with a mutex, the counters "leaders" / "followers" and three semaphores. A leader
+         checks if there are followers. If there are followers, the leader and follower match. If there are no followers,
+         it is added to the leaders queue and waits. A follower does the same the other way around, and a rendezvous
+         semaphore lets the leader leave only after its follower. Every pair takes the mutex and wakes its partner through
+         two semaphores, and the mutex is unlocked by the other thread of the pair.
 
-         Both sides are made to dance and synchronize. rendezvous semaphore allows leaders and followers to dance in synchronization and come together collectively.
+         Here both sides meet on an Exchanger (Exchanger.h) : a leader exchanges its code as the "left" side, a follower
+         as the "right" side, so a leader only pairs with a follower. The one who comes first waits in a slot of the
+         exchanger, its partner takes it with one compare_exchange and both know with whom they dance. There is no mutex,
+         so several pairs can meet at the same time.
 
          - CODE OUTPUT !!
-         The output of this code is follower, leader , follower , leader respectively. However, it does not matter who the follower and leader are.
-         The code guarantees that there is only one follower and one leader in the scene at the same time.
-         In the output you can see that the number of consecutive followers and leaders changes according to the thread speed, but each time the follower and leader are consecutive.
+         Every dancer writes its partner, e.g. :
+            1. leader is dancing with follower 2...
+            2. follower is dancing with leader 1...
+         Which leader pairs with which follower depends on the thread speed, but every leader has exactly one follower.
 
          */
 
+        Exchanger<int> danceFloor;
 
-        int leaders = 0;
-        int followers = 0;
-
-        std::mutex mutex;
-        std::counting_semaphore<4> leaderQueue(0);
-        std::counting_semaphore<4> followerQueue(0);
-        std::counting_semaphore<4> rendezvous(0);
-
-        void dance(std::string _dancer, int _dancerCode)
+        void dance(std::string _dancer, int _dancerCode, std::string _partner, int _partnerCode)
         {
-            std::cout << _dancerCode << ". " << _dancer << " is dancing..." << std::endl;
+            LOG(_dancerCode << ". " << _dancer << " is dancing with " << _partner << " " << _partnerCode << "...");
         }
 
         void leaderExecute(int _leaderCode)
         {
-            mutex.lock();
-            if (followers > 0)
-            {
-                followers--;
-                followerQueue.release();
-            }
-            else
-            {
-                leaders++;
-                mutex.unlock();
-                leaderQueue.acquire();
-            }
-
-            dance("leader", _leaderCode);
-            rendezvous.acquire();
-            mutex.unlock();
+            const int followerCode = danceFloor.exchange(_leaderCode, EExchangeSide::left);
+            dance("leader", _leaderCode, "follower", followerCode);
         }
 
         void followerExecute(int _followerCode)
         {
-            mutex.lock();
-            if (leaders > 0)
-            {
-                leaders--;
-                leaderQueue.release();
-            }
-            else
-            {
-                followers++;
-                mutex.unlock();
-                followerQueue.acquire();
-            }
-
-            dance("follower", _followerCode);
-            rendezvous.release();
+            const int leaderCode = danceFloor.exchange(_followerCode, EExchangeSide::right);
+            dance("follower", _followerCode, "leader", leaderCode);
         }
 
         void run()
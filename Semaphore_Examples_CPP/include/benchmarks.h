@@ -0,0 +1,1858 @@
+//
+// Created by agent on 10/17/2026.
+//
+
+#ifndef SEMAPHORE_EXAMPLES_CPP_BENCHMARKS_H
+#define SEMAPHORE_EXAMPLES_CPP_BENCHMARKS_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <random>
+#include <semaphore>
+#include <shared_mutex>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+#include "AdaptiveSemaphore.h"
+#include "Barrier.h"
+#include "DiningTable.h"
+#include "JoinPatternMatcher.h"
+#include "LogSink.h"
+#include "allocation_counter.h"
+#include "fast_random.h"
+#include "MPMCRingBuffer.h"
+#include "spin_wait.h"
+#include "Lightswitch.h"
+#include "RWLock.h"
+#include "ShardedPot.h"
+#include "ConcurrentOrderedList.h"
+#include "EpochReclaimer.h"
+#include "Exchanger.h"
+#include "IntrusiveWaitQueue.h"
+#include "single_linked_list.h"
+#include "classical_synchronization_problems.h"
+#include "not_so_classical_problems.h"
+
+namespace benchmarks
+{
+    /*
+     - HOW TO READ THE RESULTS !!
+     Every benchmark starts all of its threads behind a start gate, so thread creation is not measured.
+     The elapsed time is taken from the moment the gate opens until the last thread has finished its work.
+     Absolute numbers depend heavily on the machine (core count, SMT, power settings), so compare the
+     columns of one run with each other instead of comparing runs from different machines.
+     */
+
+    using Clock = std::chrono::steady_clock;
+
+    // Runs _body(threadIndex) on _threads threads and returns the elapsed wall time in seconds.
+    template <typename Body>
+    double run_threads(int _threads, Body&& _body)
+    {
+        std::atomic<int> ready{0};
+        std::atomic<bool> go{false};
+        std::vector<std::thread> threads;
+        threads.reserve(_threads);
+
+        for (int i = 0; i < _threads; ++i)
+        {
+            threads.emplace_back([&, i]
+            {
+                ready.fetch_add(1);
+                while (!go.load(std::memory_order_acquire)) { std::this_thread::yield(); }
+                _body(i);
+            });
+        }
+
+        while (ready.load() != _threads) { std::this_thread::yield(); }
+        const auto start = Clock::now();
+        go.store(true, std::memory_order_release);
+
+        for (auto& thread : threads) { if (thread.joinable()) { thread.join(); } }
+        return std::chrono::duration<double>(Clock::now() - start).count();
+    }
+
+    // Every benchmark adds the result of its busy work here, so the optimizer cannot drop it.
+    std::atomic<uint64_t> workSum{0};
+
+    // _iterations steps of busy work, the stand-in for the work a thread does while it holds (or waits for) a resource.
+    uint64_t work(int _iterations, int _seed)
+    {
+        uint64_t sum = 0;
+        for (int i = 0; i < _iterations; ++i) { sum += static_cast<uint64_t>(i ^ _seed); }
+        return sum;
+    }
+
+    // Printed instead of the allocation columns when the program is built without COUNT_ALLOCATIONS.
+    void print_allocations_off()
+    {
+        std::cout << "COUNT_ALLOCATIONS is off, configure with -DCOUNT_ALLOCATIONS=ON to measure allocations" << std::endl;
+    }
+
+    namespace barrier_benchmark
+    {
+        /*
+         - WHAT IS MEASURED !!
+            Every thread calls barrier.wait() "iterations" times. One crossing means all threads passed the barrier once.
+            The turnstile policy is the book implementation, the generation policy is the single atomic word version
+            and the combining_tree policy spreads the arrivals over a tree of counters. Thread counts go from 2 to 128,
+            the interesting part is how fast ns/crossing grows with the thread count for each policy.
+
+         - CODE OUTPUT !!
+            policy      threads   crossings/s   ns/crossing
+            turnstile         2        ...           ...
+            generation        2        ...           ...
+         */
+
+        constexpr int iterations = 2000;
+
+        const char* policy_name(EBarrierPolicy _policy)
+        {
+            switch (_policy)
+            {
+                case EBarrierPolicy::generation:     return "generation";
+                case EBarrierPolicy::combining_tree: return "tree";
+                default:                             return "turnstile";
+            }
+        }
+
+        void run()
+        {
+            std::cout << std::left << std::setw(12) << "policy" << std::right << std::setw(8) << "threads"
+                      << std::setw(16) << "crossings/s" << std::setw(14) << "ns/crossing" << std::endl;
+
+            for (int threads : {2, 4, 8, 16, 32, 64, 128})
+            {
+                for (EBarrierPolicy policy : {EBarrierPolicy::turnstile, EBarrierPolicy::generation, EBarrierPolicy::combining_tree})
+                {
+                    Barrier barrier(threads, policy);
+
+                    const double seconds = run_threads(threads, [&](int)
+                    {
+                        for (int i = 0; i < iterations; ++i) { barrier.wait(); }
+                    });
+
+                    std::cout << std::left << std::setw(12) << policy_name(policy) << std::right << std::setw(8) << threads
+                              << std::setw(16) << std::fixed << std::setprecision(0) << iterations / seconds
+                              << std::setw(14) << seconds * 1e9 / iterations << std::endl;
+                }
+            }
+        }
+    }
+
+    namespace producer_consumer_benchmark
+    {
+        /*
+         - WHAT IS MEASURED !!
+            The finite producer-consumer problem without the sleeps. Producers push "totalItems" events,
+            consumers pop them, and the items / space semaphores do the blocking in both versions:
+
+            queue : std::queue<Event> guarded by a std::mutex (the original solution)
+            ring  : MPMCRingBuffer<Event>, one CAS per push / pop and no allocation
+
+         - CODE OUTPUT !!
+            backend  producers  consumers      items/s
+            queue            1          1          ...
+            ring             1          1          ...
+         */
+
+        using classical_synchronization_problems::Event;
+
+        constexpr int totalItems = 240'000; // divisible by every producer / consumer count below
+        constexpr int bufferSize = 1024;
+
+        // Blocks for one token, then takes the tokens which are already available, up to _max.
+        template <typename Semaphore>
+        size_t acquire_some(Semaphore& _semaphore, size_t _max)
+        {
+            _semaphore.acquire();
+            size_t count = 1;
+            while (count < _max && _semaphore.try_acquire()) { ++count; }
+            return count;
+        }
+
+        class QueueBackend
+        {
+        public:
+            void push(Event&& _event)
+            {
+                space.acquire();
+                mutex.lock();
+                buffer.push(std::move(_event));
+                mutex.unlock();
+                items.release();
+            }
+
+            Event pop()
+            {
+                items.acquire();
+                mutex.lock();
+                Event event = std::move(buffer.front());
+                buffer.pop();
+                mutex.unlock();
+                space.release();
+                return event;
+            }
+
+            // Same protocol as producer_consumer_problem_finite::push_bulk / pop_bulk.
+            void push_bulk(std::span<Event> _events)
+            {
+                for (size_t pushed = 0; pushed < _events.size(); )
+                {
+                    const size_t count = acquire_some(space, _events.size() - pushed);
+                    mutex.lock();
+                    for (size_t i = 0; i < count; ++i) { buffer.push(std::move(_events[pushed + i])); }
+                    mutex.unlock();
+                    items.release(static_cast<std::ptrdiff_t>(count));
+                    pushed += count;
+                }
+            }
+
+            size_t pop_bulk(std::span<Event> _events)
+            {
+                const size_t count = acquire_some(items, _events.size());
+                mutex.lock();
+                for (size_t i = 0; i < count; ++i)
+                {
+                    _events[i] = std::move(buffer.front());
+                    buffer.pop();
+                }
+                mutex.unlock();
+                space.release(static_cast<std::ptrdiff_t>(count));
+                return count;
+            }
+
+        private:
+            std::mutex mutex;
+            std::queue<Event> buffer;
+            std::counting_semaphore<bufferSize> items{0};
+            std::counting_semaphore<bufferSize> space{bufferSize};
+        };
+
+        class RingBackend
+        {
+        public:
+            void push(Event&& _event)
+            {
+                space.acquire();
+                while (!buffer.try_push(std::move(_event))) { cpu_relax(); }
+                items.release();
+            }
+
+            Event pop()
+            {
+                items.acquire();
+                Event event;
+                while (!buffer.try_pop(event)) { cpu_relax(); }
+                space.release();
+                return event;
+            }
+
+            void push_bulk(std::span<Event> _events)
+            {
+                for (size_t pushed = 0; pushed < _events.size(); )
+                {
+                    const size_t count = acquire_some(space, _events.size() - pushed);
+                    for (size_t done = 0; done < count; )
+                    {
+                        const size_t moved = buffer.try_push_bulk(&_events[pushed + done], count - done);
+                        if (moved == 0) { cpu_relax(); }
+                        done += moved;
+                    }
+                    items.release(static_cast<std::ptrdiff_t>(count));
+                    pushed += count;
+                }
+            }
+
+            size_t pop_bulk(std::span<Event> _events)
+            {
+                const size_t count = acquire_some(items, _events.size());
+                for (size_t done = 0; done < count; )
+                {
+                    const size_t moved = buffer.try_pop_bulk(&_events[done], count - done);
+                    if (moved == 0) { cpu_relax(); }
+                    done += moved;
+                }
+                space.release(static_cast<std::ptrdiff_t>(count));
+                return count;
+            }
+
+        private:
+            MPMCRingBuffer<Event> buffer{bufferSize};
+            std::counting_semaphore<bufferSize> items{0};
+            std::counting_semaphore<bufferSize> space{bufferSize};
+        };
+
+        template <typename Backend>
+        double items_per_second(int _producers, int _consumers)
+        {
+            Backend backend;
+            const double seconds = run_threads(_producers + _consumers, [&](int _index)
+            {
+                if (_index < _producers)
+                {
+                    for (int i = 0; i < totalItems / _producers; ++i) { backend.push(Event("event")); }
+                }
+                else
+                {
+                    for (int i = 0; i < totalItems / _consumers; ++i) { backend.pop(); }
+                }
+            });
+            return totalItems / seconds;
+        }
+
+        void run()
+        {
+            std::cout << std::left << std::setw(9) << "backend" << std::right << std::setw(10) << "producers"
+                      << std::setw(11) << "consumers" << std::setw(13) << "items/s" << std::endl;
+
+            const std::pair<int, int> shapes[] = {{1, 1}, {2, 2}, {4, 4}, {8, 8}, {1, 4}, {4, 1}};
+            for (const auto& [producers, consumers] : shapes)
+            {
+                const double queue = items_per_second<QueueBackend>(producers, consumers);
+                const double ring = items_per_second<RingBackend>(producers, consumers);
+
+                std::cout << std::fixed << std::setprecision(0)
+                          << std::left << std::setw(9) << "queue" << std::right << std::setw(10) << producers
+                          << std::setw(11) << consumers << std::setw(13) << queue << std::endl
+                          << std::left << std::setw(9) << "ring" << std::right << std::setw(10) << producers
+                          << std::setw(11) << consumers << std::setw(13) << ring << std::endl;
+            }
+        }
+    }
+
+    namespace bulk_transfer_benchmark
+    {
+        /*
+         - WHAT IS MEASURED !!
+            4 producers and 4 consumers move events through the same two backends as producer_consumer_benchmark,
+            but with push_bulk / pop_bulk. A batch of N events costs one critical section (or one CAS on the ring)
+            and one release(N), so the per-event synchronization cost should fall quickly with the batch size.
+
+         - CODE OUTPUT !!
+            batch        queue items/s    ring items/s
+                1             ...              ...
+              256             ...              ...
+         */
+
+        using producer_consumer_benchmark::QueueBackend;
+        using producer_consumer_benchmark::RingBackend;
+        using producer_consumer_benchmark::totalItems;
+        using classical_synchronization_problems::Event;
+
+        constexpr int producers = 4;
+        constexpr int consumers = 4;
+
+        template <typename Backend>
+        double items_per_second(size_t _batch)
+        {
+            Backend backend;
+            const double seconds = run_threads(producers + consumers, [&](int _index)
+            {
+                std::vector<Event> batch(_batch);
+
+                if (_index < producers)
+                {
+                    for (size_t left = totalItems / producers; left > 0; )
+                    {
+                        const size_t count = std::min(_batch, left);
+                        for (size_t i = 0; i < count; ++i) { batch[i] = Event("event"); }
+                        backend.push_bulk(std::span<Event>(batch.data(), count));
+                        left -= count;
+                    }
+                }
+                else
+                {
+                    for (size_t left = totalItems / consumers; left > 0; )
+                    {
+                        left -= backend.pop_bulk(std::span<Event>(batch.data(), std::min(_batch, left)));
+                    }
+                }
+            });
+            return totalItems / seconds;
+        }
+
+        void run()
+        {
+            std::cout << std::right << std::setw(6) << "batch" << std::setw(19) << "queue items/s"
+                      << std::setw(16) << "ring items/s" << std::endl;
+
+            for (size_t batch = 1; batch <= 256; batch *= 2)
+            {
+                std::cout << std::fixed << std::setprecision(0) << std::setw(6) << batch
+                          << std::setw(19) << items_per_second<QueueBackend>(batch)
+                          << std::setw(16) << items_per_second<RingBackend>(batch) << std::endl;
+            }
+        }
+    }
+
+    namespace event_allocation_benchmark
+    {
+        /*
+         - WHAT IS MEASURED !!
+            Heap allocations per event on the hot path of the producer-consumer problem : create the event,
+            put it into the buffer, take it out again. The counter comes from allocation_counter.h, so the
+            numbers are exact (not sampled). Every case runs on one thread, there is no contention involved.
+
+            legacy copy : the old Event with a std::string member, copied in with push(event) and copied out
+                          with "Event event = buffer.front()", as the scenarios did before.
+            inline move : the current Event, moved in and out of a std::queue. What is left is the chunk
+                          allocation of std::deque, amortized over many events.
+            inline ring : the current Event moved through MPMCRingBuffer, the cells are allocated once.
+
+            Short names fit into the small-string buffer of std::string, long names do not.
+
+         - CODE OUTPUT !!
+            case          name    allocations/event
+            legacy copy   short        ...
+            legacy copy   long         ...
+         */
+
+        using classical_synchronization_problems::Event;
+
+        constexpr int events = 100'000;
+        constexpr size_t batch = 64; // events in the buffer at the same time
+
+        // Every consumed event adds its name length here, so the optimizer cannot drop the events.
+        size_t consumedCharacters = 0;
+
+        // The event type which was used before : a std::string which is copied into and out of the buffer.
+        struct LegacyEvent
+        {
+            explicit LegacyEvent(std::string _eventName = "noEvent") : eventName(std::move(_eventName)) {}
+            std::string eventName;
+        };
+
+        const char* event_name(bool _long)
+        {
+            return _long ? "a rather long event name" : "event";
+        }
+
+        template <typename Body>
+        double allocations_per_event(Body&& _body)
+        {
+            const uint64_t before = allocation_counter::thread_allocations();
+            _body();
+            return static_cast<double>(allocation_counter::thread_allocations() - before) / events;
+        }
+
+        double legacy_copy(bool _long)
+        {
+            std::queue<LegacyEvent> buffer;
+            return allocations_per_event([&]
+            {
+                for (int i = 0; i < events; i += batch)
+                {
+                    for (size_t j = 0; j < batch; ++j)
+                    {
+                        LegacyEvent event(event_name(_long));
+                        buffer.push(event);
+                    }
+                    for (size_t j = 0; j < batch; ++j)
+                    {
+                        LegacyEvent event = buffer.front();
+                        buffer.pop();
+                        consumedCharacters += event.eventName.size();
+                    }
+                }
+            });
+        }
+
+        double inline_move(bool _long)
+        {
+            std::queue<Event> buffer;
+            return allocations_per_event([&]
+            {
+                for (int i = 0; i < events; i += batch)
+                {
+                    for (size_t j = 0; j < batch; ++j) { buffer.push(Event(event_name(_long))); }
+                    for (size_t j = 0; j < batch; ++j)
+                    {
+                        Event event = std::move(buffer.front());
+                        buffer.pop();
+                        consumedCharacters += event.name().size();
+                    }
+                }
+            });
+        }
+
+        double inline_ring(bool _long)
+        {
+            MPMCRingBuffer<Event> buffer(batch);
+            return allocations_per_event([&]
+            {
+                for (int i = 0; i < events; i += batch)
+                {
+                    for (size_t j = 0; j < batch; ++j) { buffer.try_push(Event(event_name(_long))); }
+                    Event event;
+                    while (buffer.try_pop(event)) { consumedCharacters += event.name().size(); }
+                }
+            });
+        }
+
+        void run()
+        {
+#if COUNT_ALLOCATIONS
+            std::cout << std::left << std::setw(14) << "case" << std::setw(7) << "name"
+                      << std::right << std::setw(19) << "allocations/event" << std::endl;
+
+            for (bool isLong : {false, true})
+            {
+                const char* length = isLong ? "long" : "short";
+                std::cout << std::fixed << std::setprecision(3)
+                          << std::left << std::setw(14) << "legacy copy" << std::setw(7) << length
+                          << std::right << std::setw(19) << legacy_copy(isLong) << std::endl
+                          << std::left << std::setw(14) << "inline move" << std::setw(7) << length
+                          << std::right << std::setw(19) << inline_move(isLong) << std::endl
+                          << std::left << std::setw(14) << "inline ring" << std::setw(7) << length
+                          << std::right << std::setw(19) << inline_ring(isLong) << std::endl;
+            }
+#else
+            print_allocations_off();
+#endif
+        }
+    }
+
+    namespace random_event_benchmark
+    {
+        /*
+         - WHAT IS MEASURED !!
+            The cost of waitForEvent() of the producer-consumer problems, i.e. one random number plus one event.
+
+            legacy : a new std::random_device and std::mt19937 for every event, as the scenarios did before
+            cached : random_int() of fast_random.h, the generator of the thread is created only once
+
+            Every thread generates "events" events on its own, so the 4 thread line also shows whether the random
+            device becomes a shared bottleneck.
+
+         - CODE OUTPUT !!
+            generator  threads     ns/event
+            legacy           1          ...
+            cached           1          ...
+         */
+
+        using classical_synchronization_problems::Event;
+        using classical_synchronization_problems::make_numbered_event;
+
+        constexpr int events = 20'000;
+
+        // Every generated event adds its name length here, so the optimizer cannot drop the events.
+        std::atomic<size_t> generatedCharacters{0};
+
+        Event legacy_event()
+        {
+            std::random_device rd;
+            std::mt19937 gen(rd());
+            std::uniform_int_distribution<> randomNumberGenerator(1, 100);
+            return make_numbered_event(randomNumberGenerator(gen));
+        }
+
+        Event cached_event() { return make_numbered_event(random_int(1, 100)); }
+
+        template <typename Generator>
+        double ns_per_event(int _threads, Generator&& _generator)
+        {
+            const double seconds = run_threads(_threads, [&](int)
+            {
+                size_t characters = 0;
+                for (int i = 0; i < events; ++i) { characters += _generator().name().size(); }
+                generatedCharacters.fetch_add(characters, std::memory_order_relaxed);
+            });
+            return seconds * 1e9 / events;
+        }
+
+        void run()
+        {
+            std::cout << std::left << std::setw(11) << "generator" << std::right << std::setw(8) << "threads"
+                      << std::setw(13) << "ns/event" << std::endl;
+
+            for (int threads : {1, 4})
+            {
+                std::cout << std::fixed << std::setprecision(1)
+                          << std::left << std::setw(11) << "legacy" << std::right << std::setw(8) << threads
+                          << std::setw(13) << ns_per_event(threads, legacy_event) << std::endl
+                          << std::left << std::setw(11) << "cached" << std::right << std::setw(8) << threads
+                          << std::setw(13) << ns_per_event(threads, cached_event) << std::endl;
+            }
+        }
+    }
+
+    namespace logging_benchmark
+    {
+        /*
+         - WHAT IS MEASURED !!
+            Every thread runs "iterations" critical sections (a std::mutex) and prints one line in each of them, the
+            way the scenarios do it.
+
+            cout : std::cout << ... << std::endl, the iostream lock and a flush in every critical section
+            LOG  : LOG(...) of LogSink.h, the line goes into the ring of the thread and the drain thread prints it
+
+            The LOG column only counts the time of the threads. The drain thread goes on printing after that, the
+            "drained" column is the time until LogSink::flush() returns, i.e. until the last line is on stdout.
+
+         - PAY ATTENTION !!
+            Both versions really print, so run it as "Semaphore_Examples_CPP > /dev/null". The table goes to std::cerr.
+
+         - CODE OUTPUT !!
+            threads   cout sections/s    LOG sections/s   drained (ms)
+                  1         ...               ...              ...
+         */
+
+        constexpr int iterations = 20'000;
+
+        template <typename Print>
+        double sections_per_second(int _threads, Print&& _print)
+        {
+            std::mutex mutex;
+            const double seconds = run_threads(_threads, [&](int _index)
+            {
+                for (int i = 0; i < iterations; ++i)
+                {
+                    mutex.lock();
+                    _print(_index, i);
+                    mutex.unlock();
+                }
+            });
+            return _threads * iterations / seconds;
+        }
+
+        void run()
+        {
+            std::cerr << std::right << std::setw(7) << "threads" << std::setw(18) << "cout sections/s"
+                      << std::setw(18) << "LOG sections/s" << std::setw(15) << "drained (ms)" << std::endl;
+
+            for (int threads : {1, 4})
+            {
+                const double cout = sections_per_second(threads, [](int _thread, int _line)
+                {
+                    std::cout << "thread " << _thread << " is in the critical section, line " << _line << std::endl;
+                });
+
+                const auto start = Clock::now();
+                const double log = sections_per_second(threads, [](int _thread, int _line)
+                {
+                    LOG("thread " << _thread << " is in the critical section, line " << _line);
+                });
+                LogSink::instance().flush();
+                const double drained = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+                std::cerr << std::fixed << std::setprecision(0) << std::setw(7) << threads << std::setw(18) << cout
+                          << std::setw(18) << log << std::setw(15) << drained << std::endl;
+            }
+        }
+    }
+
+    namespace rw_mix_benchmark
+    {
+        /*
+         - WHAT IS MEASURED !!
+            Every thread runs "totalOperations / threads" operations, each one is a read with the probability of the
+            mix and a write otherwise. A read adds up a small shared array, a write increments it.
+
+            lightswitch  : Lightswitch + roomEmpty, RWLock<ERWLockPolicy::reader_priority>
+            shared_mutex : std::shared_mutex
+            striped      : StripedRWLock, readers are counted on per-core stripes
+
+            With a read-heavy mix the readers should scale with the thread count. The Lightswitch cannot, every reader
+            changes the same counter twice (one atomic operation each, see Lightswitch.h).
+
+         - CODE OUTPUT !!
+            reads  threads   lightswitch Mops/s  shared_mutex Mops/s   striped Mops/s
+              99%        1          ...                  ...                ...
+         */
+
+        constexpr int totalOperations = 256'000; // divisible by every thread count below
+        constexpr int dataSize = 8;
+
+        // Every read adds its sum here, so the optimizer cannot drop the reads.
+        std::atomic<uint64_t> readSum{0};
+
+        template <typename Lock>
+        double operations_per_second(int _threads, int _readPercent)
+        {
+            Lock lock;
+            uint64_t data[dataSize] = {};
+
+            const double seconds = run_threads(_threads, [&](int)
+            {
+                uint64_t sum = 0;
+                for (int i = 0; i < totalOperations / _threads; ++i)
+                {
+                    if (random_int(1, 100) <= _readPercent)
+                    {
+                        lock.lock_shared();
+                        for (uint64_t value : data) { sum += value; }
+                        lock.unlock_shared();
+                    }
+                    else
+                    {
+                        lock.lock();
+                        for (uint64_t& value : data) { ++value; }
+                        lock.unlock();
+                    }
+                }
+                readSum.fetch_add(sum, std::memory_order_relaxed);
+            });
+            return totalOperations / seconds;
+        }
+
+        void run()
+        {
+            std::cout << std::right << std::setw(5) << "reads" << std::setw(9) << "threads" << std::setw(21)
+                      << "lightswitch Mops/s" << std::setw(21) << "shared_mutex Mops/s" << std::setw(17)
+                      << "striped Mops/s" << std::endl;
+
+            for (int readPercent : {99, 90, 50})
+            {
+                for (int threads : {1, 4, 16, 64})
+                {
+                    std::cout << std::fixed << std::setprecision(2) << std::setw(4) << readPercent << '%'
+                              << std::setw(9) << threads
+                              << std::setw(21) << operations_per_second<RWLock<ERWLockPolicy::reader_priority>>(threads, readPercent) / 1e6
+                              << std::setw(21) << operations_per_second<std::shared_mutex>(threads, readPercent) / 1e6
+                              << std::setw(17) << operations_per_second<RWLock<ERWLockPolicy::striped>>(threads, readPercent) / 1e6
+                              << std::endl;
+                }
+            }
+        }
+    }
+
+    namespace rw_policy_benchmark
+    {
+        /*
+         - WHAT IS MEASURED !!
+            The same driver for every policy of RWLock.h : "readers" threads read back-to-back and "writers" threads
+            write with a short think time between two writes, all of them for "duration".
+
+            reads/s      : reader throughput
+            writer wait  : time from lock() until the writer is in, as p50 / p99 / p99.9
+
+            A policy which favours readers shows a high reads/s and a long writer tail, a policy which favours
+            writers the other way around. The fair policies are in between and keep the writer tail short.
+
+         - CODE OUTPUT !!
+            policy               reads/s   writes   wait p50 (us)   wait p99 (us)  wait p99.9 (us)
+            reader_priority        ...       ...         ...             ...              ...
+         */
+
+        constexpr int readers = 8;
+        constexpr int writers = 2;
+        constexpr int writerThinkSpins = 2'000;
+        constexpr std::chrono::milliseconds duration{300};
+        constexpr int dataSize = 8;
+
+        // Every read adds its sum here, so the optimizer cannot drop the reads.
+        std::atomic<uint64_t> readSum{0};
+
+        struct Result
+        {
+            double readsPerSecond = 0;
+            uint64_t writes = 0;
+            scenario_runtime::LatencyHistogram writerWait;
+        };
+
+        template <typename Lock>
+        void measure(Lock& _lock, Result& _result)
+        {
+            std::atomic<bool> stop{false};
+            std::atomic<uint64_t> reads{0};
+            std::atomic<uint64_t> writes{0};
+            uint64_t data[dataSize] = {};
+
+            // The last thread is the timer which ends the measurement.
+            const double seconds = run_threads(readers + writers + 1, [&](int _index)
+            {
+                if (_index < readers)
+                {
+                    uint64_t count = 0;
+                    uint64_t sum = 0;
+                    while (!stop.load(std::memory_order_relaxed))
+                    {
+                        _lock.lock_shared();
+                        for (uint64_t value : data) { sum += value; }
+                        _lock.unlock_shared();
+                        ++count;
+                    }
+                    reads.fetch_add(count, std::memory_order_relaxed);
+                    readSum.fetch_add(sum, std::memory_order_relaxed);
+                }
+                else if (_index < readers + writers)
+                {
+                    while (!stop.load(std::memory_order_relaxed))
+                    {
+                        const auto start = Clock::now();
+                        _lock.lock();
+                        const auto wait = Clock::now() - start;
+                        for (uint64_t& value : data) { ++value; }
+                        _lock.unlock();
+
+                        _result.writerWait.record(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(wait).count()));
+                        writes.fetch_add(1, std::memory_order_relaxed);
+                        for (int spin = 0; spin < writerThinkSpins; ++spin) { cpu_relax(); }
+                    }
+                }
+                else
+                {
+                    std::this_thread::sleep_for(duration);
+                    stop.store(true, std::memory_order_relaxed);
+                }
+            });
+
+            _result.readsPerSecond = reads.load() / seconds;
+            _result.writes = writes.load();
+        }
+
+        void run()
+        {
+            std::cout << std::left << std::setw(17) << "policy" << std::right << std::setw(12) << "reads/s"
+                      << std::setw(9) << "writes" << std::setw(16) << "wait p50 (us)" << std::setw(16) << "wait p99 (us)"
+                      << std::setw(17) << "wait p99.9 (us)" << std::endl;
+
+            for (ERWLockPolicy policy : allRWLockPolicies)
+            {
+                Result result;
+                rw_lock_dispatch(policy, [&](auto& _lock) { measure(_lock, result); });
+
+                std::cout << std::fixed << std::setprecision(0)
+                          << std::left << std::setw(17) << rw_lock_policy_name(policy) << std::right
+                          << std::setw(12) << result.readsPerSecond << std::setw(9) << result.writes
+                          << std::setprecision(1) << std::setw(16) << result.writerWait.percentile(50) / 1e3
+                          << std::setw(16) << result.writerWait.percentile(99) / 1e3
+                          << std::setw(17) << result.writerWait.percentile(99.9) / 1e3 << std::endl;
+            }
+        }
+    }
+
+    namespace ordered_list_benchmark
+    {
+        /*
+         - WHAT IS MEASURED !!
+            The search-insert-delete problem on a list of "size" values. Every thread runs a mix of 80% searches,
+            10% inserts and 10% deletes of random values, half of which are in the list.
+
+            lightswitch : SinglyLinkedList with the locks of the book solution (search_switch, insert_switch,
+                          insert_mutex, no_searcher, no_inserter), a delete excludes everybody else
+            concurrent  : ConcurrentOrderedList, a delete only locks the two nodes around it
+
+            Searches and deletes walk both lists from the head, so a single one costs about the same. The difference
+            is how many operations can walk the list at the same time. An insert is O(1) for SinglyLinkedList (tail
+            pointer) but a walk to its place for the sorted ConcurrentOrderedList.
+
+            Before the measurements, a check that the sentinels (INT_MIN, INT_MAX) of ConcurrentOrderedList cannot be
+            found, inserted or removed.
+
+         - CODE OUTPUT !!
+            sentinel values rejected : yes
+               size  threads   lightswitch ops/s   concurrent ops/s
+               1000        4          ...                 ...
+         */
+
+        constexpr int threads = 4;
+        constexpr int nodeVisits = 32'000'000; // per measurement, the operation count is scaled by the list size
+
+        class LightswitchList
+        {
+        public:
+            void prefill(int _value) { list.prepend(_value); }
+
+            bool search(int _value)
+            {
+                ScopedLightswitch searching(searchSwitch);
+                return list.search(_value);
+            }
+
+            bool insert(int _value)
+            {
+                ScopedLightswitch inserting(insertSwitch);
+                std::lock_guard<std::mutex> lock(insertMutex);
+                list.append(_value);
+                return true;
+            }
+
+            bool remove(int _value)
+            {
+                noSearcher.acquire();
+                noInserter.acquire();
+                const bool deleted = list.deleteValue(_value);
+                noInserter.release();
+                noSearcher.release();
+                return deleted;
+            }
+
+        private:
+            SinglyLinkedList list;
+            std::mutex insertMutex;
+            std::binary_semaphore noSearcher{1}; // released by the last one out of the switch, not by its owner
+            std::binary_semaphore noInserter{1};
+            Lightswitch<> searchSwitch{noSearcher};
+            Lightswitch<> insertSwitch{noInserter};
+        };
+
+        class ConcurrentList
+        {
+        public:
+            void prefill(int _value) { list.insert(_value); }
+            bool search(int _value) { return list.contains(_value); }
+            bool insert(int _value) { return list.insert(_value); }
+            bool remove(int _value) { return list.remove(_value); }
+
+        private:
+            ConcurrentOrderedList list;
+        };
+
+        // Every found value is counted here, so the optimizer cannot drop the searches.
+        std::atomic<uint64_t> foundValues{0};
+
+        template <typename List>
+        double operations_per_second(int _size)
+        {
+            List list;
+            // Even values from the largest one down : the sorted list inserts at its head then, a prefill is O(size).
+            for (int value = 2 * (_size - 1); value >= 0; value -= 2) { list.prefill(value); }
+
+            const int operations = std::max(64, nodeVisits / _size) / threads * threads;
+            const double seconds = run_threads(threads, [&](int)
+            {
+                uint64_t found = 0;
+                for (int i = 0; i < operations / threads; ++i)
+                {
+                    const int value = random_int(0, 2 * _size - 1);
+                    const int operation = random_int(1, 100);
+                    if (operation <= 80) { found += list.search(value); }
+                    else if (operation <= 90) { list.insert(value); }
+                    else { list.remove(value); }
+                }
+                foundValues.fetch_add(found, std::memory_order_relaxed);
+            });
+            return operations / seconds;
+        }
+
+        // The sentinels INT_MIN / INT_MAX are not values of the set : nothing may find, add or remove them.
+        bool sentinels_rejected()
+        {
+            ConcurrentOrderedList list;
+            bool rejected = true;
+            for (int sentinel : {INT_MIN, INT_MAX})
+            {
+                rejected = rejected && !list.contains(sentinel) && !list.insert(sentinel) && !list.remove(sentinel);
+            }
+            return rejected && list.insert(5) && list.contains(5) && list.remove(5) && list.size() == 0;
+        }
+
+        void run()
+        {
+            std::cout << "sentinel values rejected : " << (sentinels_rejected() ? "yes" : "NO") << std::endl;
+            std::cout << std::right << std::setw(9) << "size" << std::setw(9) << "threads" << std::setw(20)
+                      << "lightswitch ops/s" << std::setw(19) << "concurrent ops/s" << std::endl;
+
+            for (int size : {1'000, 10'000, 100'000, 1'000'000})
+            {
+                std::cout << std::fixed << std::setprecision(0) << std::setw(9) << size << std::setw(9) << threads
+                          << std::setw(20) << operations_per_second<LightswitchList>(size)
+                          << std::setw(19) << operations_per_second<ConcurrentList>(size) << std::endl;
+            }
+        }
+    }
+
+    namespace reclamation_benchmark
+    {
+        /*
+         - WHAT IS MEASURED !!
+            Searchers under delete pressure : "searchers" threads search random values back-to-back while "deleters"
+            threads delete a random value and insert it back, all of them for "duration" on a list of "size" values.
+
+            lightswitch : a delete excludes every searcher (no_searcher), so searches stop while a delete walks,
+                          and as long as one searcher is in, the deleters do not get in at all
+            concurrent  : ConcurrentOrderedList with EpochReclaimer, a delete unlinks the node while the searchers
+                          keep walking, the node is freed after the grace period
+
+            freed is the number of nodes the reclaimer freed during the measurement, it follows the deletes with a
+            delay of a few scans, so the retired memory stays bounded.
+
+         - CODE OUTPUT !!
+            deleters   list          searches/s    deletes/s      freed
+                   1   lightswitch      ...           ...          -
+                   1   concurrent       ...           ...         ...
+         */
+
+        constexpr int searchers = 4;
+        constexpr int size = 1'000;
+        constexpr std::chrono::milliseconds duration{300};
+
+        struct Result
+        {
+            double searchesPerSecond = 0;
+            double deletesPerSecond = 0;
+        };
+
+        template <typename List>
+        Result measure(int _deleters)
+        {
+            List list;
+            for (int value = size - 1; value >= 0; --value) { list.prefill(value); }
+
+            std::atomic<bool> stop{false};
+            std::atomic<uint64_t> searches{0};
+            std::atomic<uint64_t> deletes{0};
+
+            // The last thread is the timer which ends the measurement.
+            const double seconds = run_threads(searchers + _deleters + 1, [&](int _index)
+            {
+                uint64_t count = 0;
+                if (_index < searchers)
+                {
+                    uint64_t found = 0;
+                    while (!stop.load(std::memory_order_relaxed))
+                    {
+                        found += list.search(random_int(0, size - 1));
+                        ++count;
+                    }
+                    searches.fetch_add(count, std::memory_order_relaxed);
+                    ordered_list_benchmark::foundValues.fetch_add(found, std::memory_order_relaxed);
+                }
+                else if (_index < searchers + _deleters)
+                {
+                    while (!stop.load(std::memory_order_relaxed))
+                    {
+                        const int value = random_int(0, size - 1);
+                        if (list.remove(value))
+                        {
+                            list.insert(value); // keeps the list at its size
+                            ++count;
+                        }
+                    }
+                    deletes.fetch_add(count, std::memory_order_relaxed);
+                }
+                else
+                {
+                    std::this_thread::sleep_for(duration);
+                    stop.store(true, std::memory_order_relaxed);
+                }
+            });
+            return {searches.load() / seconds, deletes.load() / seconds};
+        }
+
+        void run()
+        {
+            std::cout << std::right << std::setw(8) << "deleters" << "   " << std::left << std::setw(12) << "list"
+                      << std::right << std::setw(12) << "searches/s" << std::setw(13) << "deletes/s"
+                      << std::setw(11) << "freed" << std::endl;
+
+            for (int deleters : {1, 2, 4})
+            {
+                const Result lightswitch = measure<ordered_list_benchmark::LightswitchList>(deleters);
+                const uint64_t freedBefore = EpochReclaimer::instance().freed();
+                const Result concurrent = measure<ordered_list_benchmark::ConcurrentList>(deleters);
+                const uint64_t freed = EpochReclaimer::instance().freed() - freedBefore;
+
+                std::cout << std::fixed << std::setprecision(0)
+                          << std::setw(8) << deleters << "   " << std::left << std::setw(12) << "lightswitch"
+                          << std::right << std::setw(12) << lightswitch.searchesPerSecond
+                          << std::setw(13) << lightswitch.deletesPerSecond << std::setw(11) << "-" << std::endl
+                          << std::setw(8) << deleters << "   " << std::left << std::setw(12) << "concurrent"
+                          << std::right << std::setw(12) << concurrent.searchesPerSecond
+                          << std::setw(13) << concurrent.deletesPerSecond << std::setw(11) << freed << std::endl;
+            }
+        }
+    }
+
+    namespace lightswitch_benchmark
+    {
+        /*
+         - WHAT IS MEASURED !!
+            Every thread locks and unlocks the same switch on the same room "totalOperations / threads" times, with a
+            little work in the room, like the readers of the readers-writers problem.
+
+            book   : the Lightswitch of the book, the mutex of the switch on every lock and unlock
+            atomic : Lightswitch.h, only the first in and the last out take the mutex
+
+            With one thread every lock is a 0 -> 1 transition, so both switches do the same work. With more threads most
+            arrivals find the room in use and the atomic switch skips the mutex.
+
+         - CODE OUTPUT !!
+            threads   book Mops/s   atomic Mops/s
+                  1       ...            ...
+         */
+
+        constexpr int totalOperations = 1'024'000; // divisible by every thread count below
+        constexpr int workInRoom = 16;
+
+        class BookLightswitch
+        {
+        public:
+            explicit BookLightswitch(std::binary_semaphore& _room) : room(_room) {}
+
+            void lock()
+            {
+                mutex.lock();
+                counter++;
+                if (counter == 1)
+                {
+                    room.acquire();
+                }
+                mutex.unlock();
+            }
+
+            void unlock()
+            {
+                mutex.lock();
+                counter--;
+                if (counter == 0)
+                {
+                    room.release();
+                }
+                mutex.unlock();
+            }
+
+        private:
+            std::binary_semaphore& room;
+            int counter = 0;
+            std::mutex mutex;
+        };
+
+        template <typename Switch>
+        double operations_per_second(int _threads)
+        {
+            std::binary_semaphore room{1};
+            Switch lightswitch(room);
+
+            const double seconds = run_threads(_threads, [&](int _index)
+            {
+                uint64_t sum = 0;
+                for (int i = 0; i < totalOperations / _threads; ++i)
+                {
+                    lightswitch.lock();
+                    sum += work(workInRoom, _index);
+                    lightswitch.unlock();
+                }
+                workSum.fetch_add(sum, std::memory_order_relaxed);
+            });
+            return totalOperations / seconds;
+        }
+
+        void run()
+        {
+            std::cout << std::right << std::setw(7) << "threads" << std::setw(14) << "book Mops/s"
+                      << std::setw(16) << "atomic Mops/s" << std::endl;
+
+            for (int threads : {1, 4, 16, 64})
+            {
+                std::cout << std::fixed << std::setprecision(2) << std::setw(7) << threads
+                          << std::setw(14) << operations_per_second<BookLightswitch>(threads) / 1e6
+                          << std::setw(16) << operations_per_second<Lightswitch<>>(threads) / 1e6 << std::endl;
+            }
+        }
+    }
+
+    namespace handoff_benchmark
+    {
+        /*
+         - WHAT IS MEASURED !!
+            The handoff latency of two patterns of basic_sycnhronization_patterns.h, for std::binary_semaphore and
+            AdaptiveBinarySemaphore, "rounds" times each :
+
+            signaling  : thread A takes the time and releases the semaphore, thread B measures how long it took until
+                         its acquire returned, then releases an ack so A starts the next round.
+            rendezvous : thread A releases aArrived and waits for bArrived, thread B the other way around. A measures
+                         the round trip.
+
+            With a free core for each thread the adaptive semaphore catches most handoffs while spinning and skips the
+            futex wake-up. On a busy or single core machine its spin budget shrinks and it behaves like std.
+
+         - CODE OUTPUT !!
+            pattern      semaphore     p50 (ns)   p99 (ns)  p99.9 (ns)   spin budget
+            signaling    std             ...        ...        ...            -
+            signaling    adaptive        ...        ...        ...           ...
+         */
+
+        constexpr int rounds = 20'000;
+
+        uint64_t nanoseconds_since(Clock::time_point _start)
+        {
+            return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - _start).count());
+        }
+
+        template <typename Semaphore>
+        void signaling(scenario_runtime::LatencyHistogram& _latency, Semaphore& _signal, Semaphore& _ack)
+        {
+            std::atomic<Clock::rep> releasedAt{0};
+            run_threads(2, [&](int _index)
+            {
+                for (int i = 0; i < rounds; ++i)
+                {
+                    if (_index == 0)
+                    {
+                        releasedAt.store(Clock::now().time_since_epoch().count(), std::memory_order_relaxed);
+                        _signal.release();
+                        _ack.acquire();
+                    }
+                    else
+                    {
+                        _signal.acquire();
+                        _latency.record(nanoseconds_since(Clock::time_point(Clock::duration(releasedAt.load(std::memory_order_relaxed)))));
+                        _ack.release();
+                    }
+                }
+            });
+        }
+
+        template <typename Semaphore>
+        void rendezvous(scenario_runtime::LatencyHistogram& _latency, Semaphore& _aArrived, Semaphore& _bArrived)
+        {
+            run_threads(2, [&](int _index)
+            {
+                for (int i = 0; i < rounds; ++i)
+                {
+                    if (_index == 0)
+                    {
+                        const auto start = Clock::now();
+                        _aArrived.release();
+                        _bArrived.acquire();
+                        _latency.record(nanoseconds_since(start));
+                    }
+                    else
+                    {
+                        _bArrived.release();
+                        _aArrived.acquire();
+                    }
+                }
+            });
+        }
+
+        void print(const char* _pattern, const char* _semaphore, const scenario_runtime::LatencyHistogram& _latency, int _spinBudget)
+        {
+            std::cout << std::left << std::setw(13) << _pattern << std::setw(12) << _semaphore << std::right
+                      << std::setw(10) << _latency.percentile(50) << std::setw(11) << _latency.percentile(99)
+                      << std::setw(12) << _latency.percentile(99.9) << std::setw(14);
+            if (_spinBudget < 0) { std::cout << "-"; }
+            else { std::cout << _spinBudget; }
+            std::cout << std::endl;
+        }
+
+        void run()
+        {
+            std::cout << std::left << std::setw(13) << "pattern" << std::setw(12) << "semaphore" << std::right
+                      << std::setw(10) << "p50 (ns)" << std::setw(11) << "p99 (ns)" << std::setw(12) << "p99.9 (ns)"
+                      << std::setw(14) << "spin budget" << std::endl;
+
+            {
+                scenario_runtime::LatencyHistogram latency;
+                std::binary_semaphore signal(0), ack(0);
+                signaling(latency, signal, ack);
+                print("signaling", "std", latency, -1);
+            }
+            {
+                scenario_runtime::LatencyHistogram latency;
+                AdaptiveBinarySemaphore signal(0), ack(0);
+                signaling(latency, signal, ack);
+                print("signaling", "adaptive", latency, signal.spin_budget());
+            }
+            {
+                scenario_runtime::LatencyHistogram latency;
+                std::binary_semaphore aArrived(0), bArrived(0);
+                rendezvous(latency, aArrived, bArrived);
+                print("rendezvous", "std", latency, -1);
+            }
+            {
+                scenario_runtime::LatencyHistogram latency;
+                AdaptiveBinarySemaphore aArrived(0), bArrived(0);
+                rendezvous(latency, aArrived, bArrived);
+                print("rendezvous", "adaptive", latency, bArrived.spin_budget());
+            }
+        }
+    }
+
+    namespace exchanger_benchmark
+    {
+        /*
+         - WHAT IS MEASURED !!
+            leader_and_follower_queue with half of the threads leaders and half followers. Every leader pairs
+            "totalPairs / leaders" times, a pair is counted once.
+
+            book      : the book version, a mutex (a binary semaphore, the partner unlocks it), the counters leaders /
+                        followers and the semaphores leaderQueue, followerQueue and rendezvous
+            exchanger : Exchanger.h, a leader exchanges as "left", a follower as "right"
+
+            The book version lets one pair at a time through its mutex and every pair costs at least two semaphore
+            wake-ups. The exchanger pairs with one compare_exchange and only the first of the two waits.
+
+         - CODE OUTPUT !!
+            threads   book kpairs/s   exchanger kpairs/s
+                  2        ...              ...
+         */
+
+        constexpr int totalPairs = 64'000; // divisible by every leader count below
+
+        class BookDanceFloor
+        {
+        public:
+            void leader()
+            {
+                mutex.acquire();
+                if (followers > 0)
+                {
+                    followers--;
+                    followerQueue.release();
+                }
+                else
+                {
+                    leaders++;
+                    mutex.release();
+                    leaderQueue.acquire();
+                }
+                rendezvous.acquire();
+                mutex.release();
+            }
+
+            void follower()
+            {
+                mutex.acquire();
+                if (leaders > 0)
+                {
+                    leaders--;
+                    leaderQueue.release();
+                }
+                else
+                {
+                    followers++;
+                    mutex.release();
+                    followerQueue.acquire();
+                }
+                rendezvous.release();
+            }
+
+        private:
+            int leaders = 0;
+            int followers = 0;
+            std::binary_semaphore mutex{1};
+            std::counting_semaphore<> leaderQueue{0};
+            std::counting_semaphore<> followerQueue{0};
+            std::counting_semaphore<> rendezvous{0};
+        };
+
+        class ExchangerDanceFloor
+        {
+        public:
+            void leader() { exchanger.exchange(0, EExchangeSide::left); }
+            void follower() { exchanger.exchange(0, EExchangeSide::right); }
+
+        private:
+            Exchanger<int> exchanger;
+        };
+
+        template <typename DanceFloor>
+        double pairs_per_second(int _threads)
+        {
+            DanceFloor floor;
+            const int pairsPerThread = totalPairs / (_threads / 2);
+
+            const double seconds = run_threads(_threads, [&](int _index)
+            {
+                for (int i = 0; i < pairsPerThread; ++i)
+                {
+                    if (_index % 2 == 0) { floor.leader(); }
+                    else { floor.follower(); }
+                }
+            });
+            return totalPairs / seconds;
+        }
+
+        void run()
+        {
+            std::cout << std::right << std::setw(7) << "threads" << std::setw(16) << "book kpairs/s"
+                      << std::setw(21) << "exchanger kpairs/s" << std::endl;
+
+            for (int threads : {2, 4, 8, 16, 32, 64})
+            {
+                std::cout << std::fixed << std::setprecision(1) << std::setw(7) << threads
+                          << std::setw(16) << pairs_per_second<BookDanceFloor>(threads) / 1e3
+                          << std::setw(21) << pairs_per_second<ExchangerDanceFloor>(threads) / 1e3 << std::endl;
+            }
+        }
+    }
+
+    namespace dining_benchmark
+    {
+        /*
+         - WHAT IS MEASURED !!
+            A DiningTable (DiningTable.h) with 5 to 10'000 philosophers, for "duration" per strategy. A pool of
+            min(philosophers, 64) threads serves the philosophers : thread t serves t, t + threads, t + 2 * threads ...
+            one after the other, so two neighbours never belong to the same thread (except on tiny tables).
+
+            meals/s          : finished meals of the whole table per second
+            max hunger (us)  : the longest time one philosopher waited in get_forks
+
+            footman and tanenbaum share one semaphore or one mutex between all philosophers. tanenbaum_lf (the lock-free
+            Tanenbaum) and chandy_misra only touch the words / forks next to the philosopher, so they should be the ones
+            which keep up with the ring size.
+
+         - CODE OUTPUT !!
+            philosophers  strategy         meals/s   max hunger (us)
+                       5  footman            ...           ...
+         */
+
+        constexpr auto duration = std::chrono::milliseconds(300);
+        constexpr int maxThreads = 64;
+        constexpr int workWhileEating = 64;
+
+        const char* name_of(EDiningStrategy _strategy)
+        {
+            switch (_strategy)
+            {
+                case EDiningStrategy::footman:   return "footman";
+                case EDiningStrategy::tanenbaum: return "tanenbaum";
+                case EDiningStrategy::tanenbaum_lock_free: return "tanenbaum_lf";
+                default:                         return "chandy_misra";
+            }
+        }
+
+        void measure(int _philosophers, EDiningStrategy _strategy)
+        {
+            DiningTable table(_philosophers, _strategy);
+            const int threads = std::min(_philosophers, maxThreads);
+            std::stop_source stop;
+
+            const double seconds = run_threads(threads + 1, [&](int _index)
+            {
+                if (_index == threads)
+                {
+                    std::this_thread::sleep_for(duration);
+                    stop.request_stop();
+                    return;
+                }
+
+                const std::stop_token token = stop.get_token();
+                uint64_t sum = 0;
+                while (!token.stop_requested())
+                {
+                    for (int philosopher = _index; philosopher < _philosophers; philosopher += threads)
+                    {
+                        if (!table.get_forks(philosopher, token)) { break; }
+                        sum += work(workWhileEating, philosopher);
+                        table.put_forks(philosopher);
+                    }
+                }
+                workSum.fetch_add(sum, std::memory_order_relaxed);
+            });
+
+            std::cout << std::setw(12) << _philosophers << "  " << std::left << std::setw(14) << name_of(_strategy) << std::right
+                      << std::fixed << std::setprecision(0) << std::setw(10) << table.meals() / seconds
+                      << std::setw(18) << table.max_hunger_nanoseconds() / 1'000 << std::endl;
+        }
+
+        void run()
+        {
+            std::cout << std::setw(12) << "philosophers" << "  " << std::left << std::setw(14) << "strategy" << std::right
+                      << std::setw(10) << "meals/s" << std::setw(18) << "max hunger (us)" << std::endl;
+
+            for (int philosophers : {5, 100, 1'000, 10'000})
+            {
+                for (EDiningStrategy strategy : {EDiningStrategy::footman, EDiningStrategy::tanenbaum,
+                                                 EDiningStrategy::tanenbaum_lock_free, EDiningStrategy::chandy_misra})
+                {
+                    measure(philosophers, strategy);
+                }
+            }
+        }
+    }
+
+    namespace join_matcher_benchmark
+    {
+        /*
+         - WHAT IS MEASURED !!
+            4 producers and max(8, K) consumers on K resource types (3, 16 and 48) with K recipes, recipe r needs one
+            unit of resource r and one of r + 1 (mod K), so K = 3 is the cigarette smokers table. Consumer c serves
+            recipe c % K, so every recipe has a consumer. "totalMatches" matches are made in every row, split evenly
+            over the consumers. The producers produce one kit (the resources of one recipe) per match, kit k is for
+            consumer k % consumers, producer p produces the kits k % 4 == p. Supply is exactly the demand, so every
+            consumer finishes.
+
+            mutex             : the book table, one mutex and one counter per resource, every produce wakes every
+                                consumer (condition_variable::notify_all) and each of them checks its recipe.
+            JoinPatternMatcher : atomic counters, a produce wakes only the recipes of its resource
+                                (JoinPatternMatcher.h).
+
+            With 3 resources all recipes overlap and both versions fight over the same counters. With 48 resources there
+            are 48 consumers and a resource is shared by only 2 recipes, that is where the mutex version keeps waking
+            all 48 consumers for nothing.
+
+         - CODE OUTPUT !!
+            resources  matcher             kmatches/s
+                    3  mutex                    ...
+                    3  JoinPatternMatcher       ...
+         */
+
+        constexpr int producers = 4;
+        constexpr int minConsumers = 8;
+        constexpr int totalMatches = 192'000; // divisible by 8, 16 and 48
+
+        int consumers_for(int _resources) { return std::max(minConsumers, _resources); }
+
+        class MutexJoinMatcher
+        {
+        public:
+            explicit MutexJoinMatcher(int _resourceTypes) : counts(_resourceTypes, 0) {}
+
+            int add_recipe(JoinPatternMatcher::Mask _resources)
+            {
+                recipes.push_back(_resources);
+                return static_cast<int>(recipes.size()) - 1;
+            }
+
+            void produce(int _resource)
+            {
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    ++counts[_resource];
+                }
+                changed.notify_all();
+            }
+
+            void consume(int _recipe)
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                changed.wait(lock, [&] { return can_serve(recipes[_recipe]); });
+                for (int r = 0; r < static_cast<int>(counts.size()); ++r)
+                {
+                    if (recipes[_recipe] & JoinPatternMatcher::mask_of(r)) { --counts[r]; }
+                }
+            }
+
+        private:
+            bool can_serve(JoinPatternMatcher::Mask _resources) const
+            {
+                for (int r = 0; r < static_cast<int>(counts.size()); ++r)
+                {
+                    if ((_resources & JoinPatternMatcher::mask_of(r)) && counts[r] == 0) { return false; }
+                }
+                return true;
+            }
+
+            std::mutex mutex;
+            std::condition_variable changed;
+            std::vector<int64_t> counts;
+            std::vector<JoinPatternMatcher::Mask> recipes;
+        };
+
+        JoinPatternMatcher::Mask recipe_mask(int _recipe, int _resources)
+        {
+            return JoinPatternMatcher::mask_of(_recipe) | JoinPatternMatcher::mask_of((_recipe + 1) % _resources);
+        }
+
+        template <typename Matcher, typename Consume>
+        double measure(Matcher& _matcher, int _resources, Consume _consume)
+        {
+            for (int r = 0; r < _resources; ++r) { _matcher.add_recipe(recipe_mask(r, _resources)); }
+            const int consumers = consumers_for(_resources);
+
+            return run_threads(producers + consumers, [&](int _index)
+            {
+                if (_index < producers)
+                {
+                    for (int kit = _index; kit < totalMatches; kit += producers)
+                    {
+                        const int recipe = (kit % consumers) % _resources;
+                        _matcher.produce(recipe);
+                        _matcher.produce((recipe + 1) % _resources);
+                    }
+                    return;
+                }
+
+                const int recipe = (_index - producers) % _resources;
+                for (int i = 0; i < totalMatches / consumers; ++i) { _consume(_matcher, recipe); }
+            });
+        }
+
+        void print(int _resources, const char* _matcher, double _seconds)
+        {
+            std::cout << std::setw(9) << _resources << "  " << std::left << std::setw(18) << _matcher << std::right
+                      << std::fixed << std::setprecision(0) << std::setw(11)
+                      << totalMatches / _seconds / 1'000 << std::endl;
+        }
+
+        void run()
+        {
+            std::cout << std::setw(9) << "resources" << "  " << std::left << std::setw(18) << "matcher" << std::right
+                      << std::setw(11) << "kmatches/s" << std::endl;
+
+            for (int resources : {3, 16, 48})
+            {
+                MutexJoinMatcher book(resources);
+                print(resources, "mutex", measure(book, resources, [](MutexJoinMatcher& _book, int _recipe) { _book.consume(_recipe); }));
+
+                JoinPatternMatcher matcher(resources);
+                const std::stop_token never;
+                print(resources, "JoinPatternMatcher", measure(matcher, resources, [&](JoinPatternMatcher& _matcher, int _recipe) { _matcher.consume(_recipe, never); }));
+            }
+        }
+    }
+
+    namespace savages_benchmark
+    {
+        /*
+         - WHAT IS MEASURED !!
+            8 savages eat for "duration" from the book pot of dining_savages_problem and from ShardedPot (ShardedPot.h)
+            in a few shapes. A serving is "workWhileEating" iterations, a refill of M servings costs the cook
+            "workWhileCooking" iterations.
+
+            servings/s   : servings eaten by all savages per second
+            refills      : refills the cooks delivered
+            empty waits  : savages which found every pot empty and slept until a refill (book : the savage which found
+                           the pot empty, the others wait for it on the mutex)
+
+            book              : one mutex, the savage which finds the pot empty waits for the cook with the mutex.
+            pots=1 W=0        : the atomic counter alone, the cook is still woken at the empty pot.
+            pots=1 W=M/4      : the cook starts when a quarter of the pot is left and cooks while the savages eat.
+            pots=4 / pots=8   : the savages spread over the pots, 2 and 4 cooks cook at the same time.
+
+         - CODE OUTPUT !!
+            kitchen                   servings/s   refills   empty waits
+            book                         ...         ...          ...
+         */
+
+        constexpr auto duration = std::chrono::milliseconds(300);
+        constexpr int savages = 8;
+        constexpr int M = 32;
+        constexpr int workWhileEating = 64;
+        constexpr int workWhileCooking = 4'000;
+
+        // The pot of dining_savages_problem without the logs.
+        class BookPot
+        {
+        public:
+            bool get_serving(const std::stop_token& _token)
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (servings == 0)
+                {
+                    emptyPot.release();
+                    ++emptyWaits;
+                    if (!scenario_runtime::acquire(fullPot, _token)) { return false; }
+                    servings = M;
+                }
+                servings--;
+                return true;
+            }
+
+            bool cook(const std::stop_token& _token)
+            {
+                if (!scenario_runtime::acquire(emptyPot, _token)) { return false; }
+                workSum.fetch_add(work(workWhileCooking, refills), std::memory_order_relaxed);
+                ++refills;
+                fullPot.release();
+                return true;
+            }
+
+            int servings = 0;
+            uint64_t refills = 0;    // written by the cook only
+            uint64_t emptyWaits = 0; // under mutex
+
+        private:
+            std::mutex mutex;
+            std::binary_semaphore emptyPot{0};
+            std::binary_semaphore fullPot{0};
+        };
+
+        void print(const char* _kitchen, uint64_t _servings, double _seconds, uint64_t _refills, uint64_t _emptyWaits)
+        {
+            std::cout << std::left << std::setw(24) << _kitchen << std::right << std::fixed << std::setprecision(0)
+                      << std::setw(12) << _servings / _seconds << std::setw(10) << _refills << std::setw(14) << _emptyWaits << std::endl;
+        }
+
+        // Threads 0 .. _cooks - 1 cook, the next ones eat, the last one stops the run.
+        template <typename Eat, typename Cook>
+        double drive(int _cooks, std::atomic<uint64_t>& _servings, Eat _eat, Cook _cook)
+        {
+            std::stop_source stop;
+            return run_threads(_cooks + savages + 1, [&](int _index)
+            {
+                const std::stop_token token = stop.get_token();
+                if (_index < _cooks)
+                {
+                    while (_cook(_index, token)) {}
+                    return;
+                }
+                if (_index == _cooks + savages)
+                {
+                    std::this_thread::sleep_for(duration);
+                    stop.request_stop();
+                    return;
+                }
+
+                const int savage = _index - _cooks;
+                uint64_t eaten = 0;
+                uint64_t sum = 0;
+                while (!token.stop_requested() && _eat(savage, token))
+                {
+                    ++eaten;
+                    sum += work(workWhileEating, savage);
+                }
+                _servings.fetch_add(eaten, std::memory_order_relaxed);
+                workSum.fetch_add(sum, std::memory_order_relaxed);
+            });
+        }
+
+        void measure_book()
+        {
+            BookPot pot;
+            std::atomic<uint64_t> servings{0};
+            const double seconds = drive(1, servings,
+                                         [&](int, const std::stop_token& _token) { return pot.get_serving(_token); },
+                                         [&](int, const std::stop_token& _token) { return pot.cook(_token); });
+            print("book", servings.load(), seconds, pot.refills, pot.emptyWaits);
+        }
+
+        void measure_sharded(const char* _name, int _pots, int _cooks, int _lowWatermark)
+        {
+            ShardedPot kitchen(_pots, _cooks, M, _lowWatermark);
+            std::atomic<uint64_t> servings{0};
+            const double seconds = drive(_cooks, servings,
+                                         [&](int _savage, const std::stop_token& _token) { return kitchen.get_serving(_savage, _token) >= 0; },
+                                         [&](int _cook, const std::stop_token& _token)
+                                         {
+                                             const int pot = kitchen.next_order(_cook, _token);
+                                             if (pot < 0) { return false; }
+                                             workSum.fetch_add(work(workWhileCooking, pot), std::memory_order_relaxed);
+                                             kitchen.refill(pot);
+                                             return true;
+                                         });
+            print(_name, servings.load(), seconds, kitchen.refills(), kitchen.empty_waits());
+        }
+
+        void run()
+        {
+            std::cout << std::left << std::setw(24) << "kitchen" << std::right << std::setw(12) << "servings/s"
+                      << std::setw(10) << "refills" << std::setw(14) << "empty waits" << std::endl;
+
+            measure_book();
+            measure_sharded("pots=1 cooks=1 W=0", 1, 1, 0);
+            measure_sharded("pots=1 cooks=1 W=M/4", 1, 1, M / 4);
+            measure_sharded("pots=4 cooks=2 W=M/4", 4, 2, M / 4);
+            measure_sharded("pots=8 cooks=4 W=M/4", 8, 4, M / 4);
+        }
+    }
+
+    namespace wait_queue_benchmark
+    {
+        /*
+         - WHAT IS MEASURED !!
+            The FIFO hand-off of the_fifo_barbershop_problem without the sleeps : "customers" customer threads, each
+            makes "visitsPerCustomer" visits. A customer puts its semaphore into the queue under the mutex, signals the
+            barber and waits on its semaphore, the barber takes the front of the queue under the mutex and releases it.
+
+            shared_ptr queue : std::make_shared<std::binary_semaphore> per visit in a std::queue<std::shared_ptr<...>>
+            intrusive queue  : the reused wait node of the customer thread in an IntrusiveWaitQueue (IntrusiveWaitQueue.h)
+
+            visits/s           : visits of all customers per second
+            allocations/visit  : operator new calls of all threads (allocation_counter.h) per visit, only printed when
+                                 the program is configured with -DCOUNT_ALLOCATIONS=ON
+
+         - CODE OUTPUT !!
+            queue              visits/s   allocations/visit
+            shared_ptr queue        ...               ...
+            intrusive queue         ...               ...
+         */
+
+        constexpr int customers = 8;
+        constexpr int visitsPerCustomer = 20'000;
+
+        struct SharedQueue
+        {
+            using Ticket = std::shared_ptr<std::binary_semaphore>;
+
+            Ticket ticket() { return std::make_shared<std::binary_semaphore>(0); }
+            static std::binary_semaphore& semaphore_of(const Ticket& _ticket) { return *_ticket; }
+            void push(const Ticket& _ticket) { queue.push(_ticket); }
+            Ticket pop()
+            {
+                Ticket front = queue.front();
+                queue.pop();
+                return front;
+            }
+
+            std::queue<Ticket> queue;
+        };
+
+        struct IntrusiveQueue
+        {
+            using Ticket = IntrusiveWaitQueue::Node*;
+
+            Ticket ticket() { return &IntrusiveWaitQueue::this_thread_node(); }
+            static std::binary_semaphore& semaphore_of(Ticket _ticket) { return _ticket->wakeup; }
+            void push(Ticket _ticket) { queue.push(*_ticket); }
+            Ticket pop() { return &queue.pop(); }
+
+            IntrusiveWaitQueue queue;
+        };
+
+        template <typename Queue>
+        void measure(const char* _name)
+        {
+            Queue queue;
+            std::mutex mutex;
+            std::counting_semaphore<> customer(0);
+            std::atomic<uint64_t> allocations{0};
+
+            const double seconds = run_threads(customers + 1, [&](int _index)
+            {
+                const uint64_t before = allocation_counter::thread_allocations();
+                if (_index == customers)
+                {
+                    for (int i = 0; i < customers * visitsPerCustomer; ++i)
+                    {
+                        customer.acquire();
+                        mutex.lock();
+                        typename Queue::Ticket next = queue.pop();
+                        mutex.unlock();
+                        Queue::semaphore_of(next).release();
+                    }
+                }
+                else
+                {
+                    for (int i = 0; i < visitsPerCustomer; ++i)
+                    {
+                        typename Queue::Ticket mine = queue.ticket();
+                        mutex.lock();
+                        queue.push(mine);
+                        mutex.unlock();
+                        customer.release();
+                        Queue::semaphore_of(mine).acquire();
+                    }
+                }
+                allocations.fetch_add(allocation_counter::thread_allocations() - before, std::memory_order_relaxed);
+            });
+
+            const double visits = static_cast<double>(customers) * visitsPerCustomer;
+            std::cout << std::left << std::setw(17) << _name << std::right << std::fixed
+                      << std::setprecision(0) << std::setw(10) << visits / seconds;
+#if COUNT_ALLOCATIONS
+            std::cout << std::setprecision(3) << std::setw(20) << allocations.load() / visits;
+#endif
+            std::cout << std::endl;
+        }
+
+        void run()
+        {
+#if COUNT_ALLOCATIONS
+            std::cout << std::left << std::setw(17) << "queue" << std::right << std::setw(10) << "visits/s"
+                      << std::setw(20) << "allocations/visit" << std::endl;
+#else
+            print_allocations_off();
+            std::cout << std::left << std::setw(17) << "queue" << std::right << std::setw(10) << "visits/s" << std::endl;
+#endif
+
+            measure<SharedQueue>("shared_ptr queue");
+            measure<IntrusiveQueue>("intrusive queue");
+        }
+    }
+}
+
+#endif //SEMAPHORE_EXAMPLES_CPP_BENCHMARKS_H
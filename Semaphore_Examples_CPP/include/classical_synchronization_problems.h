@@ -8,9 +8,25 @@
 #include <thread>
 #include <utility>
 #include <queue>
-#include <iostream>
-#include <random>
 #include <array>
+#include <algorithm>
+#include <charconv>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <functional>
+#include <type_traits>
+#include "MPMCRingBuffer.h"
+#include "AdaptiveSemaphore.h"
+#include "DiningTable.h"
+#include "JoinPatternMatcher.h"
+#include "RWLock.h"
+#include "fast_random.h"
+#include "spin_wait.h"
+#include "WaitForGraph.h"
+#include "LogSink.h"
+#include "scenario_runtime.h"
 
 namespace classical_synchronization_problems
 {
@@ -22,12 +38,43 @@ namespace classical_synchronization_problems
 
     class Event
     {
+        /*
+         - WHY NOT std::string !!
+         The event travels through the buffers on every produce and consume. With a std::string, a name longer than
+         the small-string buffer of the library costs a heap allocation on every copy. The name is kept in a fixed
+         inline array instead (longer names are cut), and the event can only be moved, so pushing into and popping
+         from a buffer never touches the heap because of the event itself.
+         */
     public:
-        explicit Event(std::string _eventName = "noEvent") : eventName(std::move(_eventName)) {}
-        void process() { std::cout << eventName << " is processed..." << std::endl; }
-        std::string eventName;
+        static constexpr size_t nameCapacity = 23;
+
+        explicit Event(std::string_view _eventName = "noEvent")
+        {
+            nameLength = static_cast<uint8_t>(std::min(_eventName.size(), nameCapacity));
+            std::copy_n(_eventName.data(), nameLength, eventName.data());
+        }
+
+        Event(Event&&) noexcept = default;
+        Event& operator=(Event&&) noexcept = default;
+        Event(const Event&) = delete;
+        Event& operator=(const Event&) = delete;
+
+        void process() { LOG(name() << " is processed..."); }
+        std::string_view name() const { return {eventName.data(), nameLength}; }
+
+    private:
+        std::array<char, nameCapacity> eventName{};
+        uint8_t nameLength = 0;
     };
 
+    // Writes the number into a stack buffer instead of creating a std::string with std::to_string.
+    inline Event make_numbered_event(int _number)
+    {
+        std::array<char, 16> digits{};
+        const auto result = std::to_chars(digits.data(), digits.data() + digits.size(), _number);
+        return Event(std::string_view(digits.data(), result.ptr - digits.data()));
+    }
+
     namespace producer_consumer_problem_infinite
     {
         /*
@@ -60,17 +107,15 @@ namespace classical_synchronization_problems
         std::mutex mutex;
         // When items is positive, it indicates the number of items in the buffer.
         // When it is negative, it indicates the number of consumer threads in queue
-        std::counting_semaphore<3> items(0);
+        // No small upper bound here : the buffer is infinite and push_bulk releases a whole burst at once.
+        // AdaptiveSemaphore spins a little before it sleeps, a consumer which is still running catches the next event.
+        AdaptiveSemaphore<> items(0);
         std::queue<Event> infiniteEventBuffer;
 
         Event waitForEvent()
         {
-            // Random Number Generator : Better than rand() implementation
-            std::random_device rd;
-            std::mt19937 gen(rd());
-            std::uniform_int_distribution<> randomNumberGenerator(1, 100); // random int number between 1-100
-            Event event(std::to_string(randomNumberGenerator(gen)));
-            return event;
+            // Thread-local generator from fast_random.h, no random_device / mt19937 setup per event
+            return make_numbered_event(random_int(1, 100)); // random int number between 1-100
         }
 
 /*
@@ -81,11 +126,11 @@ namespace classical_synchronization_problems
             Event event = waitForEvent(); // Local event
             mutex.lock();
             // buffer.add(event)
-            infiniteEventBuffer.push(event);
+            infiniteEventBuffer.push(std::move(event));
             items.release();
             // items.release();
             mutex.unlock();
-            std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+            scenario_runtime::pause(std::chrono::milliseconds(1000));
         }
 */
 
@@ -100,20 +145,20 @@ namespace classical_synchronization_problems
         It avoids the scenario where a consumer is blocked waiting for the semaphore while the mutex is held by the producer.
         This helps in reducing the waiting time for consumers and can lead to more efficient execution.
 */
-        void improved_producer_execute()
+        void improved_producer_execute(std::stop_token _token)
         {
-            while (true)
+            while (!_token.stop_requested())
             {
                 // WaitForEvent
                 Event event = waitForEvent(); // Local event
                 mutex.lock();
                 // buffer.add(event)
-                infiniteEventBuffer.push(event);
+                infiniteEventBuffer.push(std::move(event));
                 // items.release();
                 mutex.unlock();
                 // If we use items.release() out off the mutex, that means improved producer solution
                 items.release();
-                std::this_thread::sleep_for(std::chrono::milliseconds(2000));
+                scenario_runtime::pause(std::chrono::milliseconds(2000), _token);
             }
         }
 
@@ -140,42 +185,73 @@ namespace classical_synchronization_problems
         {
             mutex.lock();
             items.acquire();
-            Event event = infiniteEventBuffer.back(); // Local event
+            Event event = std::move(infiniteEventBuffer.back()); // Local event
             mutex.unlock();
             event.process();
         }
 */
 
-        void consumer_execute()
+        void consumer_execute(std::stop_token _token)
         {
-            while (true)
+            while (!_token.stop_requested())
             {
-                items.acquire();
+                if (!scenario_runtime::acquire(items, _token)) { return; }
                 mutex.lock();
-                Event event = infiniteEventBuffer.front(); // Local event
+                Event event = std::move(infiniteEventBuffer.front()); // Local event
                 infiniteEventBuffer.pop();
                 mutex.unlock();
                 event.process();
-                std::this_thread::sleep_for(std::chrono::milliseconds(2000));
+                scenario_runtime::pause(std::chrono::milliseconds(2000), _token);
             }
         }
 
-        void run()
+/*
+        - BULK OPERATIONS !!
+        When events arrive in bursts, paying one mutex round-trip and one items.release() per event is wasteful.
+        push_bulk moves the whole burst into the buffer under one critical section and signals the consumers
+        with a single items.release(N). pop_bulk waits for one event like a regular consumer, then takes every
+        event which is already signaled (try_acquire) up to the size of the output, again under one critical section.
+*/
+        void push_bulk(std::span<Event> _events)
         {
-            constexpr uint8_t maxElementNumber = 3;
-            std::thread producers[maxElementNumber], consumers[maxElementNumber];
+            if (_events.empty()) { return; }
 
-            for (int i = 0; i < maxElementNumber; ++i)
+            mutex.lock();
+            for (Event& event : _events) { infiniteEventBuffer.push(std::move(event)); }
+            mutex.unlock();
+            items.release(static_cast<std::ptrdiff_t>(_events.size()));
+        }
+
+        size_t pop_bulk(std::span<Event> _events)
+        {
+            if (_events.empty()) { return 0; }
+
+            items.acquire();
+            size_t count = 1;
+            while (count < _events.size() && items.try_acquire()) { ++count; }
+
+            mutex.lock();
+            for (size_t i = 0; i < count; ++i)
             {
-                producers[i] = std::thread(improved_producer_execute);
-                consumers[i] = std::thread(consumer_execute);
+                _events[i] = std::move(infiniteEventBuffer.front());
+                infiniteEventBuffer.pop();
             }
+            mutex.unlock();
+            return count;
+        }
+
+        scenario_runtime::Statistics run(std::chrono::milliseconds _duration = scenario_runtime::forever)
+        {
+            const int maxElementNumber = scenario_runtime::thread_count(3);
+            std::vector<std::jthread> threads;
 
             for (int i = 0; i < maxElementNumber; ++i)
             {
-                producers[i].join();
-                consumers[i].join();
+                threads.emplace_back(improved_producer_execute);
+                threads.emplace_back(consumer_execute);
             }
+
+            return scenario_runtime::run_for(_duration, threads);
         }
     }
 
@@ -193,84 +269,159 @@ namespace classical_synchronization_problems
          - LOGIC OF RUNNING !!
             Compared to the previous example, this example is more fault tolerant and controlled because we control the buffer occupancy.
 
+         - RING BUFFER BACKEND !!
+            With RING_BUFFER_BACKEND the std::queue + mutex pair is replaced by a fixed-capacity lock-free ring buffer.
+            The items / space semaphores still do the blocking, so the logic of the problem does not change.
+            The only difference is that adding / removing an event is a CAS on the ring instead of a mutex round-trip,
+            and no memory is allocated on push because the cells are allocated once.
+
          - CODE OUTPUT !!
             Same output instance like in infinite producer-consumer problem
          */
 
+        #define RING_BUFFER_BACKEND 0
+
         // Exclusive access to the buffer
         std::mutex mutex;
         // When items is positive, it indicates the number of items in the buffer.
         // When it is negative, it indicates the number of consumer threads in queue
-        std::counting_semaphore<3> items(0);
+        AdaptiveSemaphore<3> items(0);
         std::queue<Event> infiniteEventBuffer;
         const int bufferSize = 3;
-        std::counting_semaphore<bufferSize> space(bufferSize);
+        AdaptiveSemaphore<bufferSize> space(bufferSize);
+        #if RING_BUFFER_BACKEND
+        MPMCRingBuffer<Event> ringEventBuffer(bufferSize);
+        #endif
 
         Event waitForEvent()
         {
-            // Random Number Generator : Better than rand() implementation
-            std::random_device rd;
-            std::mt19937 gen(rd());
-            std::uniform_int_distribution<> randomNumberGenerator(1, 100); // random int number between 1-100
-            Event event(std::to_string(randomNumberGenerator(gen)));
-            return event;
+            // Thread-local generator from fast_random.h, no random_device / mt19937 setup per event
+            return make_numbered_event(random_int(1, 100)); // random int number between 1-100
         }
 
-        void producer_execute()
+        void producer_execute(std::stop_token _token)
         {
-            while (true)
+            while (!_token.stop_requested())
             {
                 // WaitForEvent
                 Event event = waitForEvent(); // Local event
-                space.acquire();
+                if (!scenario_runtime::acquire(space, _token)) { return; }
+            #if RING_BUFFER_BACKEND
+                // space guarantees a free slot, but the consumer of the previous lap may still be moving it out.
+                while (!ringEventBuffer.try_push(std::move(event))) { cpu_relax(); }
+            #else
                 mutex.lock();
                 // buffer.add(event)
-                infiniteEventBuffer.push(event);
+                infiniteEventBuffer.push(std::move(event));
                 // items.release();
                 mutex.unlock();
+            #endif
                 // If we use items.release() out off the mutex, that means improved producer solution
                 items.release();
-                std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+                scenario_runtime::pause(std::chrono::milliseconds(1000), _token);
             }
         }
 
-        void consumer_execute()
+        void consumer_execute(std::stop_token _token)
         {
-            while (true)
+            while (!_token.stop_requested())
             {
-                items.acquire();
+                if (!scenario_runtime::acquire(items, _token)) { return; }
+            #if RING_BUFFER_BACKEND
+                // items guarantees a published event, but its producer may have been overtaken by the next one.
+                Event event;
+                while (!ringEventBuffer.try_pop(event)) { cpu_relax(); }
+            #else
                 mutex.lock();
 
                 // Bad Consumer Solution - DEADLOCK PROBLEM
                 // If we use items.acquire() in the mutex, that means broken consumer solution.That causes deadlock problem.
                 // items.acquire();
 
-                Event event = infiniteEventBuffer.front(); // Local event
+                Event event = std::move(infiniteEventBuffer.front()); // Local event
                 infiniteEventBuffer.pop();
                 mutex.unlock();
+            #endif
                 space.release(); // If we put in comment this line, when buffer is full, program gets in deadlock.
 
                 event.process();
-                std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+                scenario_runtime::pause(std::chrono::milliseconds(1000), _token);
             }
         }
 
-        void run()
+/*
+        - BULK OPERATIONS !!
+        Same idea as in the infinite version, but space limits how many events fit into the buffer.
+        A producer waits for one free slot and then takes only the slots which are already free (try_acquire).
+        If it blocked for all N slots instead, two producers holding part of the slots each could wait for each other forever.
+        Whatever did not fit is pushed in the next round.
+*/
+        void push_bulk(std::span<Event> _events)
         {
-            constexpr uint8_t maxElementNumber = 3;
-            std::thread producers[maxElementNumber], consumers[maxElementNumber];
+            size_t pushed = 0;
+            while (pushed < _events.size())
+            {
+                space.acquire();
+                size_t count = 1;
+                while (pushed + count < _events.size() && space.try_acquire()) { ++count; }
 
-            for (int i = 0; i < maxElementNumber; ++i)
+            #if RING_BUFFER_BACKEND
+                for (size_t done = 0; done < count; )
+                {
+                    const size_t moved = ringEventBuffer.try_push_bulk(&_events[pushed + done], count - done);
+                    if (moved == 0) { cpu_relax(); }
+                    done += moved;
+                }
+            #else
+                mutex.lock();
+                for (size_t i = 0; i < count; ++i) { infiniteEventBuffer.push(std::move(_events[pushed + i])); }
+                mutex.unlock();
+            #endif
+                items.release(static_cast<std::ptrdiff_t>(count));
+                pushed += count;
+            }
+        }
+
+        size_t pop_bulk(std::span<Event> _events)
+        {
+            if (_events.empty()) { return 0; }
+
+            items.acquire();
+            size_t count = 1;
+            while (count < _events.size() && items.try_acquire()) { ++count; }
+
+        #if RING_BUFFER_BACKEND
+            for (size_t done = 0; done < count; )
             {
-                producers[i] = std::thread(producer_execute);
-                consumers[i] = std::thread(consumer_execute);
+                const size_t moved = ringEventBuffer.try_pop_bulk(&_events[done], count - done);
+                if (moved == 0) { cpu_relax(); }
+                done += moved;
             }
+        #else
+            mutex.lock();
+            for (size_t i = 0; i < count; ++i)
+            {
+                _events[i] = std::move(infiniteEventBuffer.front());
+                infiniteEventBuffer.pop();
+            }
+            mutex.unlock();
+        #endif
+            space.release(static_cast<std::ptrdiff_t>(count));
+            return count;
+        }
+
+        scenario_runtime::Statistics run(std::chrono::milliseconds _duration = scenario_runtime::forever)
+        {
+            const int maxElementNumber = scenario_runtime::thread_count(3);
+            std::vector<std::jthread> threads;
 
             for (int i = 0; i < maxElementNumber; ++i)
             {
-                producers[i].join();
-                consumers[i].join();
+                threads.emplace_back(producer_execute);
+                threads.emplace_back(consumer_execute);
             }
+
+            return scenario_runtime::run_for(_duration, threads);
         }
     }
 
@@ -305,122 +456,57 @@ namespace classical_synchronization_problems
          The output may be the same in both cases.
 
             Example Code of Writer-Priority
-                Writer-Priority : Reader in critical section
-                Writer-Priority : Writer in critical section
-                Writer-Priority : Writer in critical section
-                Writer-Priority : Reader in critical section
+                writer_priority : Reader in critical section
+                writer_priority : Writer in critical section
+                writer_priority : Writer in critical section
+                writer_priority : Reader in critical section
 
             Example Code of No-Writer-Priority
-                No Writer-Priority : Writer in critical section
-                No Writer-Priority : Reader in critical section
-                No Writer-Priority : Writer in critical section
-                No Writer-Priority : Reader in critical section
+                turnstile : Writer in critical section
+                turnstile : Reader in critical section
+                turnstile : Writer in critical section
+                turnstile : Reader in critical section
+
+         - POLICIES !!
+            The lock is chosen when the problem runs, e.g. run(ERWLockPolicy::writer_priority), see RWLock.h.
+            turnstile is the No Writer Priority solution above, writer_priority is the Writer Priority one.
+            With striped, readers count themselves on per-core stripes (StripedRWLock) and do not take any mutex,
+            so they no longer wait for each other on the counter of the Lightswitch.
          */
 
-        class Lightswitch
+        template <typename Lock>
+        void writer_execute(Lock& _lock, ERWLockPolicy _policy)
         {
-            /*
-             - ANALOGY !!
-            Lightswitch, by analogy with the pattern where the first person into a room turns on the light (locks the mutex)
-            and the last one out turns it off (unlocks the mutex).
-
-             The Lightswitch class manages access to a critical section using a semaphore and a counter.
-             The lock method ensures that only the first reader will acquire the semaphore, and the last reader to leave will release it.
-             The unlock method releases the semaphore if there are no more readers.
-             */
-        public:
-            Lightswitch() : counter(0) {}
-
-            void lock(std::mutex& _roomEmpty)
-            {
-                mutex.lock();
-                counter++;
-                if (counter == 1)
-                {
-                    _roomEmpty.lock();
-                }
-                mutex.unlock();
-            }
-
-            void unlock(std::mutex& _roomEmpty)
-            {
-                mutex.lock();
-                counter--;
-                if (counter == 0)
-                {
-                    _roomEmpty.unlock();
-                }
-                mutex.unlock();
-            }
-        private:
-            int counter; // keeps track of how many readers are in the room
-            std::mutex mutex;
-        };
-
-        #define WRITER_PRIORITY 0
-
-        // Code Base
-        Lightswitch readLightSwitch;
-        std::mutex roomEmpty; // 1 if there are no threads (readers or writers) in the critical section, and 0 otherwise
-        // Starving Problem
-        std::mutex turnstile; // To solve starving, turnstile for readers and a mutex for writers.
-        // Writer-Priority
-        #if WRITER_PRIORITY
-        Lightswitch readSwitch;
-        Lightswitch writeSwitch;
-        std::mutex noReaders;
-        std::mutex noWriters;
-        #endif
-
-        void writer_execute()
-        {
-        #if WRITER_PRIORITY
-            writeSwitch.lock(noReaders);
-            noWriters.lock();
-                std::cout << "Writer-Priority : Writer in critical section" << std::endl;
-            noWriters.unlock();
-            writeSwitch.unlock(noReaders);
-        #else
-            turnstile.lock(); // To solve starving
-
-            roomEmpty.lock();
-                std::cout << "No Writer-Priority : Writer in critical section" << std::endl;
-            turnstile.unlock(); // To solve starving
-
-            roomEmpty.unlock();
-        #endif
+            _lock.lock();
+                LOG(rw_lock_policy_name(_policy) << " : Writer in critical section");
+            _lock.unlock();
         }
 
-        void reader_execute()
+        template <typename Lock>
+        void reader_execute(Lock& _lock, ERWLockPolicy _policy)
         {
-        #if WRITER_PRIORITY
-            noReaders.lock();
-            readSwitch.lock(noWriters);
-            noReaders.unlock();
-                std::cout << "Writer-Priority : Reader in critical section" << std::endl;
-            readSwitch.unlock(noWriters);
-        #else
-            turnstile.lock(); // To solve starving
-            turnstile.unlock(); // To solve starving
-
-            readLightSwitch.lock(roomEmpty);
-                std::cout << "No Writer-Priority : Reader in critical section" << std::endl;
-            readLightSwitch.unlock(roomEmpty);
-        #endif
+            _lock.lock_shared();
+                LOG(rw_lock_policy_name(_policy) << " : Reader in critical section");
+            _lock.unlock_shared();
         }
 
-        void run()
+        void run(ERWLockPolicy _policy = ERWLockPolicy::turnstile)
         {
-            std::thread writer1(writer_execute);
-            std::thread reader1(reader_execute);
+            rw_lock_dispatch(_policy, [_policy](auto& _lock)
+            {
+                using Lock = std::remove_reference_t<decltype(_lock)>;
+
+                std::thread writer1(writer_execute<Lock>, std::ref(_lock), _policy);
+                std::thread reader1(reader_execute<Lock>, std::ref(_lock), _policy);
 
-            std::thread writer2(writer_execute);
-            std::thread reader2(reader_execute);
+                std::thread writer2(writer_execute<Lock>, std::ref(_lock), _policy);
+                std::thread reader2(reader_execute<Lock>, std::ref(_lock), _policy);
 
-            if (writer1.joinable()) { writer1.join(); }
-            if (writer2.joinable()) { writer2.join(); }
-            if (reader1.joinable()) { reader1.join(); }
-            if (reader2.joinable()) { reader2.join(); }
+                if (writer1.joinable()) { writer1.join(); }
+                if (writer2.joinable()) { writer2.join(); }
+                if (reader1.joinable()) { reader1.join(); }
+                if (reader2.joinable()) { reader2.join(); }
+            });
         }
     }
 
@@ -476,19 +562,19 @@ namespace classical_synchronization_problems
         int room1 = 0;
         int room2 = 0;
         // provides to control the flow of threads
-        std::binary_semaphore t1(1); // available
-        std::binary_semaphore t2(0); // unavailable
+        AdaptiveBinarySemaphore t1(1); // available
+        AdaptiveBinarySemaphore t2(0); // unavailable
 
-        void morris_algorithm()
+        void morris_algorithm(std::stop_token _token)
         {
-            while (true)
+            while (!_token.stop_requested())
             {
                 // phase 1
                 mutex.lock();
                 ++room1;
                 mutex.unlock();
 
-                t1.acquire();
+                if (!scenario_runtime::acquire(t1, _token)) { return; }
                     ++room2;
                     mutex.lock();
                     --room1;
@@ -505,181 +591,86 @@ namespace classical_synchronization_problems
                     }
 
                 // phase 2
-                t2.acquire();
+                if (!scenario_runtime::acquire(t2, _token)) { return; }
                     --room2;
 
-                    std::cout << "Thread with " << std::this_thread::get_id() << "ids in Critical Section! "  << std::endl;
+                    LOG("Thread with " << std::this_thread::get_id() << "ids in Critical Section! ");
 
                     if (room2 == 0) { t1.release(); }
                     else            { t2.release(); }
             }
         }
 
-        void run()
+        scenario_runtime::Statistics run(std::chrono::milliseconds _duration = scenario_runtime::forever)
         {
-            std::thread thread1(morris_algorithm);
-            std::thread thread2(morris_algorithm);
-            std::thread thread3(morris_algorithm);
+            std::vector<std::jthread> threads;
+            threads.emplace_back(morris_algorithm);
+            threads.emplace_back(morris_algorithm);
+            threads.emplace_back(morris_algorithm);
 
-            if (thread1.joinable()) { thread1.join(); }
-            if (thread2.joinable()) { thread2.join(); }
-            if (thread3.joinable()) { thread3.join(); }
+            return scenario_runtime::run_for(_duration, threads);
         }
     }
 
     namespace dining_philosophers
     {
-        #define IS_TANENBAUMS 0
-
         /*
          - CONSTRAINTS !!
             • Only one philosopher can hold a fork at a time.
             • It must be impossible for a deadlock to occur.
             • It must be impossible for a philosopher to starve waiting for a fork.
             • It must be possible for more than one philosopher to eat at the same time.
-         - 2 SOLUTIONS !!
+         - 3 SOLUTIONS !!
             Regular Solution
-                This solution uses a footman, a “servant” or control mechanism. The footman counter initially has a value of 4,
-                which means that a maximum of 4 philosophers can be at the table at the same time. This prevents 5 philosophers
+                This solution uses a footman, a “servant” or control mechanism. The footman counter initially has a value of n - 1,
+                which means that a maximum of n - 1 philosophers can be at the table at the same time. This prevents all philosophers
                 from requesting cutlery at the same time, which eliminates the possibility of deadlock.
             Tanenbaums Solution
-                In Tanenbaum's solution, philosophers exist in three states: thinking, hungry, hungry, eating.
-                The functions get_forks and put_forks allow each philosopher to eat or wait based on its state (EState).
+                In Tanenbaum's solution, philosophers exist in three states: thinking, hungry, eating.
+                The functions get_forks and put_forks allow each philosopher to eat or wait based on its state.
                 The test function checks whether each philosopher is allowed to eat based on the state of other philosophers around it. If the neighbors are not eating, the philosopher starts eating.
                 This solution avoids deadlock, but starvation may not be completely resolved.
+                The lock-free variant (tanenbaum_lock_free) packs the states into atomic words and lets a philosopher eat with
+                one compare_exchange, so only neighbours contend instead of the whole ring on one mutex.
+            Chandy-Misra Solution
+                The forks are passed between neighbours. A fork is dirty after a meal and clean when it is handed over.
+                A hungry philosopher takes the dirty forks of neighbours which do not eat and asks for the clean ones,
+                which it gets after their holder has eaten. No deadlock and no starvation, and no state shared by the whole table.
+
+         - DINING TABLE !!
+            All three live in DiningTable (DiningTable.h), sized at runtime : run(duration, philosophers) seats any number
+            of philosophers, "strategy" picks the solution.
          */
 
-        struct fork
-        {
-            std::binary_semaphore sem;
-
-            fork() : sem(0) {}
-            explicit fork(int _value) : sem(_value) {}
-        };
-
-        constexpr int philosophersAmount = 5;
-
-        // TODO
-        // Create a list which named forks but this cannot be implemented
-        // Because semaphores are non-moveable. it's about the lack of a copy or move constructor.
-        // To solve this we can put it into a struct or a class.
-        std::array<fork, philosophersAmount> forks {fork(1), fork(1), fork(1), fork(1), fork(1)};
-        std::counting_semaphore<4> footman(4); // to solve deadlock
-
-        int left(int _index) { return _index; } // Actually do not need it !
-        int right(int _index) { return (_index + 1) % 5; }
-
-#if IS_TANENBAUMS // If you want to use tanenbaums solution, activate the pre-processor variable !!
-
-        namespace tanenbaums
-        {
-            /*
-             In this solution while Tanenbaum’s solution effectively avoids deadlock, it does not fully address starvation.
-             Further enhancements are required to ensure that no philosopher is left waiting indefinitely.
-             */
-
-            enum class EState : uint8_t
-            {
-                thinking,
-                hungry,
-                eating
-            };
-
-            std::array<EState, philosophersAmount> states = { EState::thinking, EState::thinking, EState::thinking, EState::thinking, EState::thinking};
-            std::array<fork, philosophersAmount> tanenbaums_forks {fork(0), fork(0), fork(0), fork(0), fork(0)};
-            std::mutex mutex;
-
-            /*
-                This function checks the conditions under which a philosopher can eat
-                and, if appropriate, allows that philosopher to pick up a fork and eat.
-                This ensures synchronization and prevents philosophers from entering
-                deadlock or starvation states.
-             */
-            void test(int _index)
-            {
-                // If this philosopher's condition is hungry and
-                // If the philosopher to your left (left) and right (right) are not eating:
-                if (states[_index] == EState::hungry && states[left(_index)] != EState::eating && states[right(_index)] != EState::eating)
-                {
-                    states[_index] = EState::eating;
-                    // This philosopher is allowed to eat (forks semaphore released)
-                    tanenbaums_forks[_index].sem.release();
-                }
-            }
-
-            void put_forks(int _index)
-            {
-                mutex.lock();
-                states[_index] = EState::thinking;
-                test(right(_index));
-                test(left(_index));
-                mutex.unlock();
-            }
-            void get_forks(int _index)
-            {
-                mutex.lock();
-                states[_index] = EState::hungry;
-                test(_index);
-                mutex.unlock();
-                tanenbaums_forks[_index].sem.acquire();
-            }
-        }
-#endif
-
-        void think() { std::cout << std::this_thread::get_id() << " is thinking..." << std::endl; }
-        void eat()   { std::cout << std::this_thread::get_id() << " is eating... yummy yummy..." << std::endl; }
-
-        // Correct solution
-        void get_forks(int _index)
-        {
-            #if !IS_TANENBAUMS
-            footman.acquire();
-            forks[right(_index)].sem.acquire();
-            forks[left(_index)].sem.acquire();
-            std::cout << std::this_thread::get_id() << " got fork..." << std::endl;
-            #else
-            tanenbaums::get_forks(_index);
-            #endif
-        }
+        constexpr EDiningStrategy strategy = EDiningStrategy::footman;
 
-        void put_forks(int _index)
-        {
-            #if !IS_TANENBAUMS
-            forks[right(_index)].sem.release();
-            forks[left(_index)].sem.release();
-            footman.release();
-            std::cout << std::this_thread::get_id() << " put fork..." << std::endl;
-            #else
-            tanenbaums::put_forks(_index);
-            #endif
-        }
+        void think() { LOG(std::this_thread::get_id() << " is thinking..."); }
+        void eat()   { LOG(std::this_thread::get_id() << " is eating... yummy yummy..."); }
 
-        void execute(int _index)
+        void execute(std::stop_token _token, DiningTable& _table, int _index)
         {
-            while(true)
+            while(!_token.stop_requested())
             {
                 think();
-                get_forks(_index);
+                if (!_table.get_forks(_index, _token)) { return; }
+                LOG(std::this_thread::get_id() << " got fork...");
                 eat();
-                put_forks(_index);
+                _table.put_forks(_index);
+                LOG(std::this_thread::get_id() << " put fork...");
             }
         }
 
-        void run()
+        scenario_runtime::Statistics run(std::chrono::milliseconds _duration = scenario_runtime::forever, int _philosophers = 5)
         {
-            std::vector<std::thread> threads;
+            DiningTable table(_philosophers, strategy);
+            std::vector<std::jthread> threads;
 
-            for (int i = 0; i < philosophersAmount; ++i)
+            for (int i = 0; i < _philosophers; ++i)
             {
-                threads.emplace_back(execute, i);
+                threads.emplace_back(execute, std::ref(table), i);
             }
 
-            for (auto& thread : threads)
-            {
-                if (thread.joinable()) {
-                    thread.join();
-                }
-            }
+            return scenario_runtime::run_for(_duration, threads);
         }
     }
 
@@ -721,36 +712,37 @@ namespace classical_synchronization_problems
         constexpr uint8_t agentsAmount = 3;
         constexpr uint8_t smokersAmount = 3;
 
-        std::binary_semaphore agentSem(1);
-        std::binary_semaphore tobacco(0);
-        std::binary_semaphore paper(0);
-        std::binary_semaphore match(0);
+        // Tracked (WaitForGraph.h) : with the watchdog on, the deadlock shows up as a stall of all six threads.
+        Tracked<std::binary_semaphore> agentSem("agentSem", 1);
+        Tracked<std::binary_semaphore> tobacco("tobacco", 0);
+        Tracked<std::binary_semaphore> paper("paper", 0);
+        Tracked<std::binary_semaphore> match("match", 0);
 
-        void execute_agent(std::binary_semaphore& _ingredients1, std::binary_semaphore& _ingredients2, std::string& agent_code, std::string& put_on_table1, std::string& put_on_table2)
+        void execute_agent(std::stop_token _token, Tracked<std::binary_semaphore>& _ingredients1, Tracked<std::binary_semaphore>& _ingredients2, std::string& agent_code, std::string& put_on_table1, std::string& put_on_table2)
         {
-            while (1)
+            while (!_token.stop_requested())
             {
-                agentSem.acquire();
-                std::cout << "Agent " << agent_code << " put " << put_on_table1 << ", " << put_on_table2 << std::endl;
+                if (!scenario_runtime::acquire(agentSem, _token)) { return; }
+                LOG("Agent " << agent_code << " put " << put_on_table1 << ", " << put_on_table2);
                 _ingredients1.release();
                 _ingredients2.release();
-                std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+                scenario_runtime::pause(std::chrono::milliseconds(1000), _token);
             }
         }
 
-        void execute_smokers(std::binary_semaphore& _ingredients1, std::binary_semaphore& _ingredients2, std::string& take_on_table1, std::string& take_on_table2)
+        void execute_smokers(std::stop_token _token, Tracked<std::binary_semaphore>& _ingredients1, Tracked<std::binary_semaphore>& _ingredients2, std::string& take_on_table1, std::string& take_on_table2)
         {
-            while (1)
+            while (!_token.stop_requested())
             {
-                _ingredients1.acquire();
-                _ingredients2.acquire();
-                std::cout << "Smoker took " << take_on_table1 << " and " << take_on_table2 << " then smoking...\n";
+                if (!scenario_runtime::acquire(_ingredients1, _token)) { return; }
+                if (!scenario_runtime::acquire(_ingredients2, _token)) { return; }
+                LOG("Smoker took " << take_on_table1 << " and " << take_on_table2 << " then smoking...");
                 agentSem.release();
-                std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+                scenario_runtime::pause(std::chrono::milliseconds(1000), _token);
             }
         }
 
-        void run()
+        scenario_runtime::Statistics run(std::chrono::milliseconds _duration = scenario_runtime::forever)
         {
             std::string agent_code_A = "A";
             std::string agent_code_B = "B";
@@ -760,20 +752,15 @@ namespace classical_synchronization_problems
             std::string tobacco_staff = "tobacco";
             std::string paper_staff = "paper";
 
-            std::array<std::thread, agentsAmount> agents = {
-                    std::thread(execute_agent, std::ref(tobacco), std::ref(paper), std::ref(agent_code_A), std::ref(tobacco_staff), std::ref(paper_staff)), // Agent A
-                    std::thread(execute_agent, std::ref(paper), std::ref(match), std::ref(agent_code_B), std::ref(paper_staff), std::ref(match_staff)), // Agent B
-                    std::thread(execute_agent, std::ref(tobacco), std::ref(match), std::ref(agent_code_C), std::ref(tobacco_staff), std::ref(match_staff))  // Agent C
-            };
-
-            std::array<std::thread, smokersAmount> smokers = {
-                    std::thread(execute_smokers, std::ref(tobacco), std::ref(paper), std::ref(tobacco_staff), std::ref(paper_staff)), // Smoker with matches
-                    std::thread(execute_smokers, std::ref(paper), std::ref(match), std::ref(paper_staff), std::ref(match_staff)), // Smoker with tobacco
-                    std::thread(execute_smokers, std::ref(tobacco), std::ref(match), std::ref(tobacco_staff), std::ref(match_staff))  // Smoker with paper
-            };
+            std::vector<std::jthread> threads;
+            threads.emplace_back(execute_agent, std::ref(tobacco), std::ref(paper), std::ref(agent_code_A), std::ref(tobacco_staff), std::ref(paper_staff)); // Agent A
+            threads.emplace_back(execute_agent, std::ref(paper), std::ref(match), std::ref(agent_code_B), std::ref(paper_staff), std::ref(match_staff)); // Agent B
+            threads.emplace_back(execute_agent, std::ref(tobacco), std::ref(match), std::ref(agent_code_C), std::ref(tobacco_staff), std::ref(match_staff)); // Agent C
+            threads.emplace_back(execute_smokers, std::ref(tobacco), std::ref(paper), std::ref(tobacco_staff), std::ref(paper_staff)); // Smoker with matches
+            threads.emplace_back(execute_smokers, std::ref(paper), std::ref(match), std::ref(paper_staff), std::ref(match_staff)); // Smoker with tobacco
+            threads.emplace_back(execute_smokers, std::ref(tobacco), std::ref(match), std::ref(tobacco_staff), std::ref(match_staff)); // Smoker with paper
 
-            for (auto& agent : agents)   { if (agent.joinable())  { agent.join();  } }
-            for (auto& smoker : smokers) { if (smoker.joinable()) { smoker.join(); } }
+            return scenario_runtime::run_for(_duration, threads);
         }
     }
 
@@ -849,11 +836,11 @@ namespace classical_synchronization_problems
         std::binary_semaphore paper(0);
         std::binary_semaphore match(0);
 
-        void execute_pusher(std::binary_semaphore& _mainIngredient, std::binary_semaphore& _ingredient1, std::binary_semaphore& _ingredient2,
+        void execute_pusher(std::stop_token _token, std::binary_semaphore& _mainIngredient, std::binary_semaphore& _ingredient1, std::binary_semaphore& _ingredient2,
                             std::atomic<bool>& _mainIndicator,      std::atomic<bool>& _indicator1,      std::atomic<bool>& _indicator2)
         {
             {
-                _mainIngredient.acquire();
+                if (!scenario_runtime::acquire(_mainIngredient, _token)) { return; }
                 mutex.lock();
 
                 if (_indicator1)
@@ -872,35 +859,35 @@ namespace classical_synchronization_problems
                 }
 
                 mutex.unlock();
-                std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+                scenario_runtime::pause(std::chrono::milliseconds(1000), _token);
             }
         }
 
-        void execute_agent(std::binary_semaphore& _ingredients1, std::binary_semaphore& _ingredients2, std::string& agent_code, std::string& staff_on_table1, std::string& staff_on_table2)
+        void execute_agent(std::stop_token _token, std::binary_semaphore& _ingredients1, std::binary_semaphore& _ingredients2, std::string& agent_code, std::string& staff_on_table1, std::string& staff_on_table2)
         {
-            while(true)
+            while(!_token.stop_requested())
             {
-                agentSem.acquire();
-                std::cout << "Agent " << agent_code << " put " << staff_on_table1 << ", " << staff_on_table2 << std::endl;
+                if (!scenario_runtime::acquire(agentSem, _token)) { return; }
+                LOG("Agent " << agent_code << " put " << staff_on_table1 << ", " << staff_on_table2);
                 _ingredients1.release();
                 _ingredients2.release();
-                std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+                scenario_runtime::pause(std::chrono::milliseconds(1000), _token);
             }
         }
 
-        void execute_smokers(std::binary_semaphore& _mainIngredients, std::string& staff_on_table1, std::string& staff_on_table2)
+        void execute_smokers(std::stop_token _token, std::binary_semaphore& _mainIngredients, std::string& staff_on_table1, std::string& staff_on_table2)
         {
-            while(true)
+            while(!_token.stop_requested())
             {
-                _mainIngredients.acquire();
-                std::cout << "Smoker took " << staff_on_table1 << " and " << staff_on_table2 << " then made cigarette...\n";
+                if (!scenario_runtime::acquire(_mainIngredients, _token)) { return; }
+                LOG("Smoker took " << staff_on_table1 << " and " << staff_on_table2 << " then made cigarette...");
                 agentSem.release();
-                std::cout << "Smoking...\n";
-                std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+                LOG("Smoking...");
+                scenario_runtime::pause(std::chrono::milliseconds(1000), _token);
             }
         }
 
-        void run()
+        scenario_runtime::Statistics run(std::chrono::milliseconds _duration = scenario_runtime::forever)
         {
             std::string agent_code_A = "A";
             std::string agent_code_B = "B";
@@ -910,27 +897,18 @@ namespace classical_synchronization_problems
             std::string tobacco_staff = "tobacco";
             std::string paper_staff = "paper";
 
-            std::array<std::thread, agentsAmount> agents = {
-                    std::thread(execute_agent, std::ref(tobacco), std::ref(paper), std::ref(agent_code_A), std::ref(tobacco_staff), std::ref(paper_staff)), // Agent A
-                    std::thread(execute_agent, std::ref(paper), std::ref(match), std::ref(agent_code_B), std::ref(paper_staff), std::ref(match_staff)), // Agent B
-                    std::thread(execute_agent, std::ref(tobacco), std::ref(match), std::ref(agent_code_C), std::ref(tobacco_staff), std::ref(match_staff))  // Agent C
-            };
-
-            std::array<std::thread, smokersAmount> smokers = {
-                    std::thread(execute_smokers, std::ref(match), std::ref(tobacco_staff), std::ref(paper_staff)), // Smoker with matches
-                    std::thread(execute_smokers, std::ref(tobacco), std::ref(paper_staff), std::ref(match_staff)), // Smoker with tobacco
-                    std::thread(execute_smokers, std::ref(paper), std::ref(tobacco_staff), std::ref(match_staff))  // Smoker with paper
-            };
-
-            std::array<std::thread, agentsAmount> pushers = {
-                    std::thread(execute_pusher, std::ref(tobacco), std::ref(paper),   std::ref(match), std::ref(isTobacco), std::ref(isPaper),   std::ref(isMatch)), // Pusher A
-                    std::thread(execute_pusher, std::ref(paper),   std::ref(tobacco), std::ref(match), std::ref(isPaper),   std::ref(isTobacco), std::ref(isMatch)), // Pusher B
-                    std::thread(execute_pusher, std::ref(match),   std::ref(tobacco), std::ref(paper), std::ref(isMatch),   std::ref(isTobacco), std::ref(isPaper))  // Pusher C
-            };
-
-            for (auto &agent: agents)   { if (agent.joinable())  { agent.join();  }}
-            for (auto &smoker: smokers) { if (smoker.joinable()) { smoker.join(); }}
-            for (auto &pusher: pushers) { if (pusher.joinable()) { pusher.join(); }}
+            std::vector<std::jthread> threads;
+            threads.emplace_back(execute_agent, std::ref(tobacco), std::ref(paper), std::ref(agent_code_A), std::ref(tobacco_staff), std::ref(paper_staff)); // Agent A
+            threads.emplace_back(execute_agent, std::ref(paper), std::ref(match), std::ref(agent_code_B), std::ref(paper_staff), std::ref(match_staff)); // Agent B
+            threads.emplace_back(execute_agent, std::ref(tobacco), std::ref(match), std::ref(agent_code_C), std::ref(tobacco_staff), std::ref(match_staff)); // Agent C
+            threads.emplace_back(execute_smokers, std::ref(match), std::ref(tobacco_staff), std::ref(paper_staff)); // Smoker with matches
+            threads.emplace_back(execute_smokers, std::ref(tobacco), std::ref(paper_staff), std::ref(match_staff)); // Smoker with tobacco
+            threads.emplace_back(execute_smokers, std::ref(paper), std::ref(tobacco_staff), std::ref(match_staff)); // Smoker with paper
+            threads.emplace_back(execute_pusher, std::ref(tobacco), std::ref(paper),   std::ref(match), std::ref(isTobacco), std::ref(isPaper),   std::ref(isMatch)); // Pusher A
+            threads.emplace_back(execute_pusher, std::ref(paper),   std::ref(tobacco), std::ref(match), std::ref(isPaper),   std::ref(isTobacco), std::ref(isMatch)); // Pusher B
+            threads.emplace_back(execute_pusher, std::ref(match),   std::ref(tobacco), std::ref(paper), std::ref(isMatch),   std::ref(isTobacco), std::ref(isPaper)); // Pusher C
+
+            return scenario_runtime::run_for(_duration, threads);
         }
     }
 
@@ -938,73 +916,58 @@ namespace classical_synchronization_problems
     {
         // If the agents don’t wait for the smokers, ingredients might accumulate on the table.
         // Instead of using boolean values to keep track of ingredients, we need integers to count them.
-        int numTobacco = 0;
-        int numPaper = 0;
-        int numMatch = 0;
 
-        // Beginning Code
-        constexpr uint8_t agentsAmount = 3;
-        constexpr uint8_t smokersAmount = 3;
-
-        std::mutex mutex;
+        /*
+         - JOIN PATTERN !!
+            The book version counts the ingredients with numTobacco / numPaper / numMatch under one mutex, and three
+            pushers (one per ingredient) look at the counters and signal the smoker whose ingredients are complete.
+            Here the table is a JoinPatternMatcher (JoinPatternMatcher.h) : every ingredient is a resource type, every
+            smoker a recipe (the bitmask of the two ingredients it lacks). An agent produces its two ingredients, a
+            smoker consumes its recipe and gets both at once. The counters are atomic and there are no pushers and no
+            mutex. The same matcher takes dozens of ingredient types and any recipes.
 
-        std::binary_semaphore agentSem(1);
-        std::binary_semaphore tobacco(0);
-        std::binary_semaphore paper(0);
-        std::binary_semaphore match(0);
+         - CODE OUTPUT !!
+            Agent A put tobacco, paper
+            Smoker took tobacco and paper then made cigarette...
+            Smoking...
+            ...
+         */
 
-        void execute_pusher(std::binary_semaphore& _mainIngredient, std::binary_semaphore& _ingredient1, std::binary_semaphore& _ingredient2,
-                            int& _mainIndicator, int& _indicator1, int& _indicator2)
+        enum EIngredient : int
         {
-            {
-                _mainIngredient.acquire();
-                mutex.lock();
-
-                if (_indicator1)
-                {
-                    _indicator1--;
-                    _ingredient2.release();
-                }
-                else if (_indicator2)
-                {
-                    _indicator2--;
-                    _ingredient1.release();
-                }
-                else
-                {
-                    _mainIndicator++;
-                }
+            tobacco,
+            paper,
+            match,
+            ingredientsAmount
+        };
 
-                mutex.unlock();
-                std::this_thread::sleep_for(std::chrono::milliseconds(1000));
-            }
-        }
+        std::binary_semaphore agentSem(1);
 
-        void execute_agent(std::binary_semaphore& _ingredients1, std::binary_semaphore& _ingredients2, std::string& agent_code, std::string& staff_on_table1, std::string& staff_on_table2)
+        void execute_agent(std::stop_token _token, JoinPatternMatcher& _table, EIngredient _ingredient1, EIngredient _ingredient2, std::string& agent_code, std::string& staff_on_table1, std::string& staff_on_table2)
         {
-            while(true)
+            while(!_token.stop_requested())
             {
-                agentSem.acquire();
-                std::cout << "Agent " << agent_code << " put " << staff_on_table1 << ", " << staff_on_table2 << std::endl;
-                _ingredients1.release();
-                _ingredients2.release();
-                std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+                if (!scenario_runtime::acquire(agentSem, _token)) { return; }
+                LOG("Agent " << agent_code << " put " << staff_on_table1 << ", " << staff_on_table2);
+                _table.produce(_ingredient1);
+                _table.produce(_ingredient2);
+                scenario_runtime::pause(std::chrono::milliseconds(1000), _token);
             }
         }
 
-        void execute_smokers(std::binary_semaphore& _mainIngredients, std::string& staff_on_table1, std::string& staff_on_table2)
+        void execute_smokers(std::stop_token _token, JoinPatternMatcher& _table, int _recipe, std::string& staff_on_table1, std::string& staff_on_table2)
         {
-            while(true)
+            while(!_token.stop_requested())
             {
-                _mainIngredients.acquire();
-                std::cout << "Smoker took " << staff_on_table1 << " and " << staff_on_table2 << " then made cigarette...\n";
+                if (!_table.consume(_recipe, _token)) { return; }
+                LOG("Smoker took " << staff_on_table1 << " and " << staff_on_table2 << " then made cigarette...");
                 agentSem.release();
-                std::cout << "Smoking...\n";
-                std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+                LOG("Smoking...");
+                scenario_runtime::pause(std::chrono::milliseconds(1000), _token);
             }
         }
 
-        void run()
+        scenario_runtime::Statistics run(std::chrono::milliseconds _duration = scenario_runtime::forever)
         {
             std::string agent_code_A = "A";
             std::string agent_code_B = "B";
@@ -1014,27 +977,20 @@ namespace classical_synchronization_problems
             std::string tobacco_staff = "tobacco";
             std::string paper_staff = "paper";
 
-            std::array<std::thread, agentsAmount> agents = {
-                    std::thread(execute_agent, std::ref(tobacco), std::ref(paper), std::ref(agent_code_A), std::ref(tobacco_staff), std::ref(paper_staff)), // Agent A
-                    std::thread(execute_agent, std::ref(paper), std::ref(match), std::ref(agent_code_B), std::ref(paper_staff), std::ref(match_staff)), // Agent B
-                    std::thread(execute_agent, std::ref(tobacco), std::ref(match), std::ref(agent_code_C), std::ref(tobacco_staff), std::ref(match_staff))  // Agent C
-            };
-
-            std::array<std::thread, smokersAmount> smokers = {
-                    std::thread(execute_smokers, std::ref(match), std::ref(tobacco_staff), std::ref(paper_staff)), // Smoker with matches
-                    std::thread(execute_smokers, std::ref(tobacco), std::ref(paper_staff), std::ref(match_staff)), // Smoker with tobacco
-                    std::thread(execute_smokers, std::ref(paper), std::ref(tobacco_staff), std::ref(match_staff))  // Smoker with paper
-            };
-
-            std::array<std::thread, agentsAmount> pushers = {
-                    std::thread(execute_pusher, std::ref(tobacco), std::ref(paper),   std::ref(match), std::ref(numTobacco), std::ref(numPaper),   std::ref(numMatch)), // Pusher A
-                    std::thread(execute_pusher, std::ref(paper),   std::ref(tobacco), std::ref(match), std::ref(numPaper),   std::ref(numTobacco), std::ref(numMatch)), // Pusher B
-                    std::thread(execute_pusher, std::ref(match),   std::ref(tobacco), std::ref(paper), std::ref(numMatch),   std::ref(numTobacco), std::ref(numPaper))  // Pusher C
-            };
-
-            for (auto &agent: agents)   { if (agent.joinable())  { agent.join();  }}
-            for (auto &smoker: smokers) { if (smoker.joinable()) { smoker.join(); }}
-            for (auto &pusher: pushers) { if (pusher.joinable()) { pusher.join(); }}
+            JoinPatternMatcher table(ingredientsAmount);
+            const int withMatches = table.add_recipe(JoinPatternMatcher::mask_of(tobacco) | JoinPatternMatcher::mask_of(paper));
+            const int withTobacco = table.add_recipe(JoinPatternMatcher::mask_of(paper) | JoinPatternMatcher::mask_of(match));
+            const int withPaper = table.add_recipe(JoinPatternMatcher::mask_of(tobacco) | JoinPatternMatcher::mask_of(match));
+
+            std::vector<std::jthread> threads;
+            threads.emplace_back(execute_agent, std::ref(table), tobacco, paper, std::ref(agent_code_A), std::ref(tobacco_staff), std::ref(paper_staff)); // Agent A
+            threads.emplace_back(execute_agent, std::ref(table), paper, match, std::ref(agent_code_B), std::ref(paper_staff), std::ref(match_staff)); // Agent B
+            threads.emplace_back(execute_agent, std::ref(table), tobacco, match, std::ref(agent_code_C), std::ref(tobacco_staff), std::ref(match_staff)); // Agent C
+            threads.emplace_back(execute_smokers, std::ref(table), withMatches, std::ref(tobacco_staff), std::ref(paper_staff)); // Smoker with matches
+            threads.emplace_back(execute_smokers, std::ref(table), withTobacco, std::ref(paper_staff), std::ref(match_staff)); // Smoker with tobacco
+            threads.emplace_back(execute_smokers, std::ref(table), withPaper, std::ref(tobacco_staff), std::ref(match_staff)); // Smoker with paper
+
+            return scenario_runtime::run_for(_duration, threads);
         }
     }
 }
@@ -0,0 +1,90 @@
+//
+// Created by agent on 10/17/2026.
+//
+
+#ifndef SEMAPHORE_EXAMPLES_CPP_FAST_RANDOM_H
+#define SEMAPHORE_EXAMPLES_CPP_FAST_RANDOM_H
+
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <random>
+
+/*
+ - WHY NOT std::random_device + std::mt19937 !!
+ The scenarios used to create a std::random_device and a std::mt19937 for every random number. The random device
+ is usually a system call (or a hardware instruction), and the Mersenne Twister has 5 KB of state which is filled
+ on every construction. That is far more work than the synchronization the examples want to show.
+
+ FastRandom is xoshiro256** : 32 bytes of state, a few shifts and rotations per number and good statistical
+ quality for workload generation (it is NOT meant for cryptography). Every thread owns one generator, created the
+ first time that thread asks for a number, so there is nothing to share and nothing to lock.
+
+ - SEEDING !!
+ The process reads std::random_device only once. Each thread adds its own increment of the golden ratio to that
+ seed and expands it with splitmix64, so the threads get unrelated streams even when they start at the same time.
+ */
+
+class FastRandom
+{
+public:
+    using result_type = uint64_t;
+
+    explicit FastRandom(uint64_t _seed)
+    {
+        for (auto& word : state) { word = splitmix64(_seed); }
+    }
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+    result_type operator()()
+    {
+        const uint64_t result = rotate_left(state[1] * 5, 7) * 9;
+        const uint64_t t = state[1] << 17;
+
+        state[2] ^= state[0];
+        state[3] ^= state[1];
+        state[1] ^= state[2];
+        state[0] ^= state[3];
+        state[2] ^= t;
+        state[3] = rotate_left(state[3], 45);
+
+        return result;
+    }
+
+    // Uniform int in [_min, _max]. Multiply-shift instead of a modulo, the bias is below range / 2^32.
+    int uniform_int(int _min, int _max)
+    {
+        const uint64_t range = static_cast<uint64_t>(static_cast<int64_t>(_max) - _min) + 1;
+        return static_cast<int>(_min + static_cast<int64_t>(((*this)() >> 32) * range >> 32));
+    }
+
+private:
+    static uint64_t rotate_left(uint64_t _value, int _shift) { return (_value << _shift) | (_value >> (64 - _shift)); }
+
+    static uint64_t splitmix64(uint64_t& _seed)
+    {
+        uint64_t z = (_seed += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+    uint64_t state[4];
+};
+
+// The generator of the calling thread.
+inline FastRandom& thread_random()
+{
+    static const uint64_t processSeed = (static_cast<uint64_t>(std::random_device{}()) << 32) ^ std::random_device{}();
+    static std::atomic<uint64_t> nextThread{0};
+
+    thread_local FastRandom generator(processSeed + 0x9E3779B97F4A7C15ull * nextThread.fetch_add(1, std::memory_order_relaxed));
+    return generator;
+}
+
+// Random int in [_min, _max] from the generator of the calling thread.
+inline int random_int(int _min, int _max) { return thread_random().uniform_int(_min, _max); }
+
+#endif //SEMAPHORE_EXAMPLES_CPP_FAST_RANDOM_H
@@ -5,8 +5,8 @@
 #ifndef SEMAPHORE_EXAMPLES_CPP_INTRODUCTION_H
 #define SEMAPHORE_EXAMPLES_CPP_INTRODUCTION_H
 
-#include <iostream>
 #include <condition_variable>
+#include "LogSink.h"
 
 namespace introduction
 {
@@ -48,11 +48,11 @@ namespace introduction
 
         void threadA()
         {
-            std::cout << "Me: Eating breakfast" << std::endl;
-            std::cout << "Me: Working" << std::endl;
-            std::cout << "Me: Eating lunch" << std::endl;
+            LOG("Me: Eating breakfast");
+            LOG("Me: Working");
+            LOG("Me: Eating lunch");
 
-            std::cout << "Me: Calling Bob" << std::endl;
+            LOG("Me: Calling Bob");
             isBobCalled = true;
 
             /*
@@ -73,14 +73,14 @@ namespace introduction
 
         void threadB()
         {
-            std::cout << "Bob: Eating breakfast" << std::endl;
+            LOG("Bob: Eating breakfast");
 
             std::unique_lock<std::mutex> lock(mtx);
 
             cv.wait(lock, []{ return isBobCalled; });
 
-            std::cout << "Bob: Received call from Me" << std::endl;
-            std::cout << "Bob: Eating lunch" << std::endl;
+            LOG("Bob: Received call from Me");
+            LOG("Bob: Eating lunch");
 
             mtx.unlock();
         }
@@ -111,8 +111,8 @@ namespace introduction
 
          */
 
-        void threadA() { std::cout << "YES!\n" << std::endl; }
-        void threadB() { std::cout << "NO!\n" << std::endl; }
+        void threadA() { LOG("YES!\n"); }
+        void threadB() { LOG("NO!\n"); }
 
         void run()
         {
@@ -143,7 +143,7 @@ namespace introduction
         void threadA(int& x)
         {
             x = 5;
-            std::cout << x << std::endl;
+            LOG(x);
         }
 
         void threadB(int& x)
@@ -213,7 +213,7 @@ namespace introduction
             tA.join();
             tB.join();
 
-            std::cout << "Result : " << x << std::endl;
+            LOG("Result : " << x);
 
             return 0;
         }
@@ -8,6 +8,11 @@
 #include <thread>
 #include <mutex>
 #include <queue>
+#include "LogSink.h"
+#include "scenario_runtime.h"
+#include "InstrumentedSync.h"
+#include "ShardedPot.h"
+#include "IntrusiveWaitQueue.h"
 
 namespace less_classical_synchronization_problems
 {
@@ -36,24 +41,88 @@ namespace less_classical_synchronization_problems
 
             The output will repeat as savages continue to eat and the cook continues to refill the pot whenever it's empty.
             The specific thread IDs and order of actions may vary because the threads run concurrently.
+
+         - SHARDED POTS !!
+            Above, every savage takes the mutex for one serving and the savage which finds the pot empty waits for the
+            cook while it holds the mutex, so all savages wait for the cook and the cook only starts when the pot is
+            empty. With SHARDED_POTS the savages eat from a ShardedPot (ShardedPot.h) : several pots with atomic
+            servings counters, one cook per pot or per few pots, and the cook is woken when a pot gets down to
+            lowWatermark servings, so it cooks while the savages still eat. A savage only waits when every pot is empty.
+
+            Output :
+                Savage got the serving from pot 1..
+                3. savage is eating..
+                Cook 0 put servings into pot 0!!
+                ...
          */
 
+        #define SHARDED_POTS 0
+
         constexpr int savage_number = 3;
         constexpr int M = 5; // stands for serving amount
+        #if SHARDED_POTS
+        constexpr int pots = 2;
+        constexpr int cooks = 2;
+        constexpr int lowWatermark = 1; // the cook is woken when a pot has this many servings left
+        #else
         int servings = 0;
         std::mutex mutex;
         std::binary_semaphore emptyPot(0); // It is binary semaphore, because we deal with just it is empty or not
         std::binary_semaphore fullPot(0); // It is binary semaphore, because we deal with just it is empty or not
+        #endif
+
+        #if SHARDED_POTS
+        void execute_savage(std::stop_token _token, ShardedPot& _kitchen, int _savage)
+        {
+            while (!_token.stop_requested())
+            {
+                const int pot = _kitchen.get_serving(_savage, _token); // sleeps only when every pot is empty
+                if (pot < 0) { return; }
+                LOG("Savage got the serving from pot " << pot << "..");
+                LOG(std::this_thread::get_id() << ". savage is eating.."); // eat();
+            }
+        }
 
-        void execute_savage()
+        void execute_cook(std::stop_token _token, ShardedPot& _kitchen, int _cook)
         {
-            while(true)
+            while (!_token.stop_requested())
+            {
+                const int pot = _kitchen.next_order(_cook, _token); // a pot of this cook is at the watermark
+                if (pot < 0) { return; }
+                _kitchen.refill(pot);
+                LOG("Cook " << _cook << " put servings into pot " << pot << "!!"); // put_servings_in_pot(M);
+            }
+        }
+
+        scenario_runtime::Statistics run(std::chrono::milliseconds _duration = scenario_runtime::forever)
+        {
+            ShardedPot kitchen(pots, cooks, M, lowWatermark);
+            std::vector<std::jthread> threads;
+            const int savage_amount = scenario_runtime::thread_count(savage_number);
+
+            for (int i = 0; i < cooks; ++i)
+            {
+                threads.emplace_back(execute_cook, std::ref(kitchen), i);
+            }
+
+            for (int i = 0; i < savage_amount; ++i)
+            {
+                threads.emplace_back(execute_savage, std::ref(kitchen), i);
+            }
+
+            return scenario_runtime::run_for(_duration, threads);
+        }
+        #else
+
+        void execute_savage(std::stop_token _token)
+        {
+            while (!_token.stop_requested())
             {
                 mutex.lock(); // if a thread gets in, others have to wait till it is available.
                 if (servings == 0) // No portions to eat means pot is empty
                 {
                     emptyPot.release(); // pot is empty so deal with implementations when pot is empty
-                    fullPot.acquire(); // blocked to stop transactions that take place while the pot is full
+                    if (!scenario_runtime::acquire(fullPot, _token)) { mutex.unlock(); return; } // blocked to stop transactions that take place while the pot is full
 
                     /*
                      Why savage is reset the servings ? if u r saying, I could not understand. Shouldn't the cook do it ?
@@ -73,40 +142,37 @@ namespace less_classical_synchronization_problems
 
                 }
                 servings--; // decrease the pot
-                std::cout << "Savage got the serving from pot..\n"; // get_serving_from_pot();
+                LOG("Savage got the serving from pot.."); // get_serving_from_pot();
                 mutex.unlock();
-                std::cout << std::this_thread::get_id() << ". savage is eating..\n"; // eat();
+                LOG(std::this_thread::get_id() << ". savage is eating.."); // eat();
             }
         }
 
-        void execute_cook()
+        void execute_cook(std::stop_token _token)
         {
-            while (true)
+            while (!_token.stop_requested())
             {
-                emptyPot.acquire(); // if pot is empty
-                std::cout << "Servings is put into pot by cook!!\n"; // put_servings_in_pot(M);
+                if (!scenario_runtime::acquire(emptyPot, _token)) { return; } // if pot is empty
+                LOG("Servings is put into pot by cook!!"); // put_servings_in_pot(M);
                 fullPot.release(); // arrange pot is full
             }
         }
 
-        void run()
+        scenario_runtime::Statistics run(std::chrono::milliseconds _duration = scenario_runtime::forever)
         {
-            std::vector<std::thread> savages;
+            std::vector<std::jthread> threads;
+            const int savage_amount = scenario_runtime::thread_count(savage_number);
 
-            std::thread cook(execute_cook);
+            threads.emplace_back(execute_cook);
 
-            for (int i = 0; i < savage_number; ++i)
+            for (int i = 0; i < savage_amount; ++i)
             {
-                 savages.push_back(std::thread(execute_savage));
+                 threads.emplace_back(execute_savage);
             }
 
-            if (cook.joinable()) { cook.join(); }
-
-            for (int i = 0; i < savage_number; ++i)
-            {
-                if (savages.at(i).joinable()) { savages.at(i).join(); }
-            }
+            return scenario_runtime::run_for(_duration, threads);
         }
+        #endif
     }
 
     namespace the_barbershop_problem
@@ -141,34 +207,35 @@ namespace less_classical_synchronization_problems
 
         constexpr int n = 4; // total number of customers, 3 in waiting room, 1 in chair
         int customer_counter = 0; // number of customers in the shop
-        std::mutex mutex;
-        std::binary_semaphore barber(0); // there is just one barber
-        std::binary_semaphore customer(0); // customer who is shaving
-        std::binary_semaphore barber_done(0); // signals to the customer when barber is done.
-        std::binary_semaphore customer_done(0); // signals to the barber when customer is done.
-
-        void execute_customer()
+        // Instrumented : the benchmark harness shows which of them the threads wait on (InstrumentedSync.h).
+        Instrumented<std::mutex> mutex("mutex");
+        Instrumented<std::binary_semaphore> barber("barber", 0); // there is just one barber
+        Instrumented<std::binary_semaphore> customer("customer", 0); // customer who is shaving
+        Instrumented<std::binary_semaphore> barber_done("barber_done", 0); // signals to the customer when barber is done.
+        Instrumented<std::binary_semaphore> customer_done("customer_done", 0); // signals to the barber when customer is done.
+
+        void execute_customer(std::stop_token _token)
         {
-            while (true)
+            while (!_token.stop_requested())
             {
                 mutex.lock();
                 if (customer_counter == n)
                 {
                     mutex.unlock();
-                    std::cout << std::this_thread::get_id() << ". customer is balked..\n"; // balk();
+                    LOG(std::this_thread::get_id() << ". customer is balked.."); // balk();
                     return;
                 }
                 customer_counter++;
                 mutex.unlock();
 
                 customer.release();
-                barber.acquire();
+                if (!scenario_runtime::acquire(barber, _token)) { return; }
 
-                std::cout << std::this_thread::get_id() << ". customer got hair cut..\n"; // getHairCut();
-                std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+                LOG(std::this_thread::get_id() << ". customer got hair cut.."); // getHairCut();
+                scenario_runtime::pause(std::chrono::milliseconds(1000), _token);
 
                 customer_done.release();
-                barber_done.acquire();
+                if (!scenario_runtime::acquire(barber_done, _token)) { return; }
 
                 mutex.lock();
                 customer_counter--;
@@ -176,36 +243,31 @@ namespace less_classical_synchronization_problems
             }
         }
 
-        void execute_barber()
+        void execute_barber(std::stop_token _token)
         {
-            while (true)
+            while (!_token.stop_requested())
             {
-                customer.acquire();
+                if (!scenario_runtime::acquire(customer, _token)) { return; }
                 barber.release();
-                std::cout << "Barber cut the customers hair...\n"; // cutHair();
-                std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+                LOG("Barber cut the customers hair..."); // cutHair();
+                scenario_runtime::pause(std::chrono::milliseconds(1000), _token);
 
-                customer_done.acquire();
+                if (!scenario_runtime::acquire(customer_done, _token)) { return; }
                 barber_done.release();
             }
         }
 
-        void run()
+        scenario_runtime::Statistics run(std::chrono::milliseconds _duration = scenario_runtime::forever)
         {
-            std::vector<std::thread> customers_thread;
-            std::thread barber_thread(execute_barber);
+            std::vector<std::jthread> threads;
+            threads.emplace_back(execute_barber);
 
             for (int i = 0; i < n+2; ++i) // More than n customers
             {
-                customers_thread.push_back(std::thread(execute_customer));
-            }
-
-            for (int i = 0; i < n; ++i)
-            {
-                if (customers_thread.at(i).joinable()) { customers_thread.at(i).join(); }
+                threads.emplace_back(execute_customer);
             }
 
-            if (barber_thread.joinable()) { barber_thread.join(); }
+            return scenario_runtime::run_for(_duration, threads);
         }
     }
 
@@ -255,12 +317,12 @@ namespace less_classical_synchronization_problems
             3. customer got hair cut..
             Barber cut the customers hair...
             6. customer got hair cut..
-         */
 
-        struct sem
-        {
-            std::binary_semaphore own_sem = std::binary_semaphore(0);
-        };
+         - WAIT NODES !!
+            The semaphore of a customer used to be a new std::make_shared<sem> for every visit, in a
+            std::queue<std::shared_ptr<sem>>. Now every customer thread has one wait node (IntrusiveWaitQueue.h) for
+            all of its visits and the queue links the nodes, so a visit allocates nothing.
+         */
 
         constexpr int n = 4; // total number of customers, 3 in waiting room, 1 in chair
         int customer_counter = 0; // number of customers in the shop
@@ -269,19 +331,19 @@ namespace less_classical_synchronization_problems
         std::binary_semaphore customer(0); // customer who is shaving
         std::binary_semaphore barber_done(0); // signals to the customer when barber is done.
         std::binary_semaphore customer_done(0); // signals to the barber when customer is done.
-        std::queue<std::shared_ptr<sem>> customers_fifo; // solver the synch problem.
+        IntrusiveWaitQueue customers_fifo; // solver the synch problem.
 
-        void execute_customer()
+        void execute_customer(std::stop_token _token)
         {
-            while (true)
+            while (!_token.stop_requested())
             {
-                auto s = std::make_shared<sem>(); // Create a shared pointer to sem
+                IntrusiveWaitQueue::Node& s = IntrusiveWaitQueue::this_thread_node(); // own semaphore, the same one for every visit
 
                 mutex.lock();
                 if (customer_counter == n)
                 {
                     mutex.unlock();
-                    std::cout << std::this_thread::get_id() << ". customer is balked..\n"; // balk();
+                    LOG(std::this_thread::get_id() << ". customer is balked.."); // balk();
                     return;
                 }
                 customer_counter++;
@@ -289,13 +351,13 @@ namespace less_classical_synchronization_problems
                 mutex.unlock();
 
                 customer.release();
-                s->own_sem.acquire();
+                if (!scenario_runtime::acquire(s.wakeup, _token)) { return; }
 
-                std::cout << std::this_thread::get_id() << ". customer got hair cut..\n"; // getHairCut();
-                std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+                LOG(std::this_thread::get_id() << ". customer got hair cut.."); // getHairCut();
+                scenario_runtime::pause(std::chrono::milliseconds(1000), _token);
 
                 customer_done.release();
-                barber_done.acquire();
+                if (!scenario_runtime::acquire(barber_done, _token)) { return; }
 
                 mutex.lock();
                 customer_counter--;
@@ -303,44 +365,38 @@ namespace less_classical_synchronization_problems
             }
         }
 
-        void execute_barber()
+        void execute_barber(std::stop_token _token)
         {
-            while (true)
+            while (!_token.stop_requested())
             {
-                customer.acquire();
+                if (!scenario_runtime::acquire(customer, _token)) { return; }
                 mutex.lock();
 
-                auto s = customers_fifo.front();
-                customers_fifo.pop();
+                IntrusiveWaitQueue::Node& s = customers_fifo.pop();
 
                 mutex.unlock();
 
-                s->own_sem.release();
+                s.wakeup.release();
 
-                std::cout << "Barber cut the customers hair...\n"; // cutHair();
-                std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+                LOG("Barber cut the customers hair..."); // cutHair();
+                scenario_runtime::pause(std::chrono::milliseconds(1000), _token);
 
-                customer_done.acquire();
+                if (!scenario_runtime::acquire(customer_done, _token)) { return; }
                 barber_done.release();
             }
         }
 
-        void run()
+        scenario_runtime::Statistics run(std::chrono::milliseconds _duration = scenario_runtime::forever)
         {
-            std::vector<std::thread> customers_thread;
-            std::thread barber_thread(execute_barber);
+            std::vector<std::jthread> threads;
+            threads.emplace_back(execute_barber);
 
             for (int i = 0; i < n+2; ++i) // More than n customers
             {
-                customers_thread.push_back(std::thread(execute_customer));
+                threads.emplace_back(execute_customer);
             }
 
-            for (int i = 0; i < n; ++i)
-            {
-                if (customers_thread.at(i).joinable()) { customers_thread.at(i).join(); }
-            }
-
-            if (barber_thread.joinable()) { barber_thread.join(); }
+            return scenario_runtime::run_for(_duration, threads);
         }
     }
 
@@ -397,63 +453,65 @@ namespace less_classical_synchronization_problems
 
         constexpr int n = 20; // capacity
         int customer_counter = 0;
-        std::mutex mutex;
-        std::counting_semaphore<4> sofa(4); // Sofa capacity counter
-        std::binary_semaphore customer1(0);
-        std::binary_semaphore customer2(0);
-        std::binary_semaphore barber(0);
-        std::binary_semaphore payment(0);
-        std::binary_semaphore receipt(0);
-
-        std::queue<std::shared_ptr<std::binary_semaphore>> queue1;
-        std::queue<std::shared_ptr<std::binary_semaphore>> queue2;
-
-        void execute_customer()
+        // Instrumented : the benchmark harness shows which of them the threads wait on (InstrumentedSync.h).
+        Instrumented<std::mutex> mutex("mutex");
+        Instrumented<std::counting_semaphore<4>> sofa("sofa", 4); // Sofa capacity counter
+        Instrumented<std::binary_semaphore> customer1("customer1", 0);
+        Instrumented<std::binary_semaphore> customer2("customer2", 0);
+        Instrumented<std::binary_semaphore> barber("barber", 0);
+        Instrumented<std::binary_semaphore> payment("payment", 0);
+        Instrumented<std::binary_semaphore> receipt("receipt", 0);
+
+        // Wait nodes of the customer threads (IntrusiveWaitQueue.h), reused for every visit. A customer stands in
+        // queue2 while the barber may still be inside the release of its queue1 node, so it has one node per queue.
+        IntrusiveWaitQueue queue1;
+        IntrusiveWaitQueue queue2;
+
+        void execute_customer(std::stop_token _token)
         {
-            while (true)
+            while (!_token.stop_requested())
             {
-                auto s1 = std::make_shared<std::binary_semaphore>(0); // Create a shared pointer to sem
-                auto s2 = std::make_shared<std::binary_semaphore>(0); // Create a shared pointer to sem
+                IntrusiveWaitQueue::Node& s1 = IntrusiveWaitQueue::this_thread_node(0);
+                IntrusiveWaitQueue::Node& s2 = IntrusiveWaitQueue::this_thread_node(1);
 
                 mutex.lock();
                 if (customer_counter == n)
                 {
                     // If barbershop is full.
                     mutex.unlock();
-                    std::cout << std::this_thread::get_id() << ". customer is balked..\n"; // balk();
+                    LOG(std::this_thread::get_id() << ". customer is balked.."); // balk();
                     return;
                 }
                 customer_counter++; // barbershop is not full and a customer entered.
                 queue1.push(s1); // add this_thread own semaphore into the queue.
                 mutex.unlock();
 
-                std::cout << std::this_thread::get_id() << ". customer entered the barbershop..\n"; // enterShop();
-                std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+                LOG(std::this_thread::get_id() << ". customer entered the barbershop.."); // enterShop();
+                scenario_runtime::pause(std::chrono::milliseconds(1000), _token);
 
                 customer1.release(); // Signal that a customer is waiting to be served. This allows the barber to start processing.
-                s1->acquire(); // Wait till the barber is ready for shaving. When barber ready, he releases the semaphore.
+                if (!scenario_runtime::acquire(s1.wakeup, _token)) { return; } // Wait till the barber is ready for shaving. When barber ready, he releases the semaphore.
 
-                sofa.acquire(); // Customer who entered in the barbershop sat on sofa.
+                if (!scenario_runtime::acquire(sofa, _token)) { return; } // Customer who entered in the barbershop sat on sofa.
 
-                std::cout << std::this_thread::get_id() << ". customer sat on sofa..\n"; // sitOnSofa();
-                std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+                LOG(std::this_thread::get_id() << ". customer sat on sofa.."); // sitOnSofa();
+                scenario_runtime::pause(std::chrono::milliseconds(1000), _token);
 
-                s1->release(); // Release the semaphore s1 after the customer has been served (sat on the sofa).
                 mutex.lock();
                 queue2.push(s2);
                 mutex.unlock();
                 customer2.release(); // Signal that this customer is now ready to be served in the barber chair.
-                s2->acquire(); // Wait till the barber is ready for this customer (seated in the barber chair).
+                if (!scenario_runtime::acquire(s2.wakeup, _token)) { return; } // Wait till the barber is ready for this customer (seated in the barber chair).
                 sofa.release();
 
-                std::cout << std::this_thread::get_id() << ". customer sit in barber chair..\n"; // sitInBarberChair();
-                std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+                LOG(std::this_thread::get_id() << ". customer sit in barber chair.."); // sitInBarberChair();
+                scenario_runtime::pause(std::chrono::milliseconds(1000), _token);
 
-                std::cout << std::this_thread::get_id() << ". customer paid..\n"; // pay();
-                std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+                LOG(std::this_thread::get_id() << ". customer paid.."); // pay();
+                scenario_runtime::pause(std::chrono::milliseconds(1000), _token);
 
                 payment.release(); // customer pay for shaving.
-                receipt.acquire(); // wait till the barber accept the payment.
+                if (!scenario_runtime::acquire(receipt, _token)) { return; } // wait till the barber accept the payment.
 
                 mutex.lock();
                 customer_counter--; // 1 customer is done. Here using the mutex because to provide the sync.
@@ -461,62 +519,51 @@ namespace less_classical_synchronization_problems
             }
         }
 
-        void execute_barber() {
-            while (true) {
-                customer1.acquire(); // Wait till there is a customer who is ready to be served. This ensures the barber only works when there is a customer.
+        void execute_barber(std::stop_token _token) {
+            while (!_token.stop_requested()) {
+                if (!scenario_runtime::acquire(customer1, _token)) { return; } // Wait till there is a customer who is ready to be served. This ensures the barber only works when there is a customer.
                 mutex.lock();
-                auto s = queue1.front();
-                queue1.pop(); // Get the semaphore for the customer waiting on the sofa (s1).
-                s->release(); // Allow the customer to proceed to the sofa.
-                s->acquire(); // Wait till the customer is seated on the sofa and is ready for the barber.
+                IntrusiveWaitQueue::Node& s1 = queue1.pop(); // Get the semaphore for the customer waiting on the sofa (s1).
                 mutex.unlock();
-                s->release(); // Release the semaphore after ensuring the customer is ready.
+                // s1 is released exactly once per visit. The customer reuses it for its next visit, a left over release
+                // would let that visit pass before a barber took it from queue1.
+                s1.wakeup.release(); // Allow the customer to proceed to the sofa.
 
-                customer2.acquire(); // Wait till the customer is ready to get into the barber chair.
+                if (!scenario_runtime::acquire(customer2, _token)) { return; } // Wait till the customer is ready to get into the barber chair.
                 mutex.lock();
-                s = queue2.front(); // Get the semaphore for the customer waiting in the barber chair queue (s2).s
-                queue2.pop();
+                IntrusiveWaitQueue::Node& s2 = queue2.pop(); // Get the semaphore for the customer waiting in the barber chair queue (s2).
                 mutex.unlock();
-                s->release(); // Allow the customer to get into the barber chair.
+                s2.wakeup.release(); // Allow the customer to get into the barber chair.
 
                 barber.release();
 
-                std::cout << std::this_thread::get_id() << ". customer cut hair..\n"; // cutHair();
-                std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+                LOG(std::this_thread::get_id() << ". customer cut hair.."); // cutHair();
+                scenario_runtime::pause(std::chrono::milliseconds(1000), _token);
 
-                payment.acquire();
+                if (!scenario_runtime::acquire(payment, _token)) { return; }
 
-                std::cout << "Barber accepted the payment\n" ; // acceptPayment();
-                std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+                LOG("Barber accepted the payment"); // acceptPayment();
+                scenario_runtime::pause(std::chrono::milliseconds(1000), _token);
 
                 receipt.release();
             }
         }
 
-        void run()
+        scenario_runtime::Statistics run(std::chrono::milliseconds _duration = scenario_runtime::forever)
         {
-            std::vector<std::thread> customers_thread;
-            std::vector<std::thread> barbers_thread;
+            std::vector<std::jthread> threads;
 
             for (int i = 0; i < n+2; ++i) // More than n customers
             {
-                customers_thread.push_back(std::thread(execute_customer));
+                threads.emplace_back(execute_customer);
             }
 
             for (int i = 0; i < 3; ++i)
             {
-                barbers_thread.push_back(std::thread(execute_barber));
+                threads.emplace_back(execute_barber);
             }
 
-            for (int i = 0; i < n+2; ++i)
-            {
-                if (customers_thread.at(i).joinable()) { customers_thread.at(i).join(); }
-            }
-
-            for (int i = 0; i < 3; ++i)
-            {
-                if (barbers_thread.at(i).joinable()) { barbers_thread.at(i).join(); }
-            }
+            return scenario_runtime::run_for(_duration, threads);
         }
     }
 
@@ -568,16 +615,16 @@ namespace less_classical_synchronization_problems
         std::binary_semaphore elfTex(1);
         std::mutex mutex;
 
-        void execute_santa()
+        void execute_santa(std::stop_token _token)
         {
-            while (true)
+            while (!_token.stop_requested())
             {
-                santaSem.acquire();
+                if (!scenario_runtime::acquire(santaSem, _token)) { return; }
                 mutex.lock();
 
                 if (reindeer_counter == reindeer_number)
                 {
-                    std::cout << "Santa Claus preparing sleigh...\n"; // prepareSleigh();
+                    LOG("Santa Claus preparing sleigh..."); // prepareSleigh();
                     for (int i = 0; i < reindeer_number; ++i)
                     {
                         reindeerSem.release();
@@ -586,15 +633,15 @@ namespace less_classical_synchronization_problems
                 }
                 else if (elf_counter == 3)
                 {
-                    std::cout << "Santa Claus helping elves...\n"; // helpElves();
+                    LOG("Santa Claus helping elves..."); // helpElves();
                 }
                 mutex.unlock();
             }
         }
 
-        void execute_reindeer()
+        void execute_reindeer(std::stop_token _token)
         {
-            while (true)
+            while (!_token.stop_requested())
             {
                 mutex.lock();
                 reindeer_counter++;
@@ -604,18 +651,18 @@ namespace less_classical_synchronization_problems
                 }
                 mutex.unlock();
 
-                reindeerSem.acquire();
-                std::cout << std::this_thread::get_id() << " numbered reindeer getting hitched...\n"; // getHitched();
-                std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+                if (!scenario_runtime::acquire(reindeerSem, _token)) { return; }
+                LOG(std::this_thread::get_id() << " numbered reindeer getting hitched..."); // getHitched();
+                scenario_runtime::pause(std::chrono::milliseconds(1000), _token);
 
             }
         }
 
-        void execute_elf()
+        void execute_elf(std::stop_token _token)
         {
-            while (true)
+            while (!_token.stop_requested())
             {
-                elfTex.acquire();
+                if (!scenario_runtime::acquire(elfTex, _token)) { return; }
                 mutex.lock();
 
                 elf_counter++;
@@ -630,8 +677,8 @@ namespace less_classical_synchronization_problems
 
                 mutex.unlock();
 
-                std::cout << std::this_thread::get_id() << " numbered elf will get help...\n"; // getHelp();
-                std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+                LOG(std::this_thread::get_id() << " numbered elf will get help..."); // getHelp();
+                scenario_runtime::pause(std::chrono::milliseconds(1000), _token);
 
                 mutex.lock();
 
@@ -645,19 +692,15 @@ namespace less_classical_synchronization_problems
             }
         }
 
-        void run()
+        scenario_runtime::Statistics run(std::chrono::milliseconds _duration = scenario_runtime::forever)
         {
-            std::vector<std::thread> elves;
-            std::vector<std::thread> reindeers;
-            std::thread santa(execute_santa);
-
-            for (int i = 0; i < elves_number; ++i) { elves.push_back(std::thread(execute_elf)); }
-            for (int i = 0; i < reindeer_number; ++i) { reindeers.push_back(std::thread(execute_reindeer)); }
+            std::vector<std::jthread> threads;
+            threads.emplace_back(execute_santa);
 
-            if (santa.joinable()) { santa.join(); }
+            for (int i = 0; i < elves_number; ++i) { threads.emplace_back(execute_elf); }
+            for (int i = 0; i < reindeer_number; ++i) { threads.emplace_back(execute_reindeer); }
 
-            for (auto& elf : elves) { if (elf.joinable()) { elf.join(); } }
-            for (auto& reinder : reindeers) { if (reinder.joinable()) { reinder.join(); } }
+            return scenario_runtime::run_for(_duration, threads);
         }
     }
 
@@ -722,7 +765,7 @@ namespace less_classical_synchronization_problems
             }
 
             oxygen_fifo.acquire(); // wait until allowed to bond
-            std::cout << "2 atoms bound each other!" << std::endl;
+            LOG("2 atoms bound each other!");
             barrier.arrive_and_wait(); // wait for other threads to finish bonding
 
             mutex.unlock(); // release the mutex after bonding
@@ -745,7 +788,7 @@ namespace less_classical_synchronization_problems
             }
 
             hydrogen_fifo.acquire(); // wait until allowed to bond
-            std::cout << "2 atoms bound each other!" << std::endl;
+            LOG("2 atoms bound each other!");
             barrier.arrive_and_wait(); // wait for other threads to finish bonding
         }
         void run()
@@ -803,12 +846,12 @@ namespace less_classical_synchronization_problems
             }
 
             hackers_fifo.acquire();
-            std::cout << "Hacker : Board the boat\n"; // board();
+            LOG("Hacker : Board the boat"); // board();
             barrier.wait();
 
             if (isCaptain)
             {
-                std::cout << "Hacker : Captain rows the boat\n";// rowBoat();
+                LOG("Hacker : Captain rows the boat");// rowBoat();
                 mutex.unlock();
             }
         }
@@ -839,12 +882,12 @@ namespace less_classical_synchronization_problems
             }
 
             serfs_fifo.acquire();
-            std::cout << "Serf : Board the boat\n"; // board();
+            LOG("Serf : Board the boat"); // board();
             barrier.wait();
 
             if (isCaptain)
             {
-                std::cout << "Serf : Captain rows the boat\n";// rowBoat();
+                LOG("Serf : Captain rows the boat");// rowBoat();
                 mutex.unlock();
             }
         }
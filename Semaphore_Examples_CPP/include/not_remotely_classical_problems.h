@@ -5,10 +5,11 @@
 #ifndef SEMAPHORE_EXAMPLES_CPP_NOT_REMOTELY_CLASSICAL_PROBLEMS_H
 #define SEMAPHORE_EXAMPLES_CPP_NOT_REMOTELY_CLASSICAL_PROBLEMS_H
 
-#include <iostream>
 #include <mutex>
 #include <thread>
 #include <array>
+#include "LogSink.h"
+#include "scenario_runtime.h"
 
 namespace not_remotely_classical_problems
 {
@@ -89,11 +90,11 @@ namespace not_remotely_classical_problems
             }
 
             eating_counter++;
-            std::cout << "Eating count : " << eating_counter << "\n";
+            LOG("Eating count : " << eating_counter);
             must_wait = eating_counter == seat_amount;
             mutex.unlock();
 
-            std::cout << "Thread with " << std::this_thread::get_id() << " id eating sushi\n";
+            LOG("Thread with " << std::this_thread::get_id() << " id eating sushi");
 
             mutex.lock();
             eating_counter--;
@@ -190,8 +191,8 @@ namespace not_remotely_classical_problems
                 mutex.unlock();
             }
 
-            std::cout << "Eating count : " << eating_counter << "\n";
-            std::cout << "Thread with " << std::this_thread::get_id() << " id eating sushi\n";
+            LOG("Eating count : " << eating_counter);
+            LOG("Thread with " << std::this_thread::get_id() << " id eating sushi");
 
             mutex.lock();
             eating_counter--;
@@ -260,8 +261,8 @@ namespace not_remotely_classical_problems
                 mutex.unlock();
             }
 
-            std::cout << "Eating count : " << eating_counter << "\n";
-            std::cout << "Thread with " << std::this_thread::get_id() << " id eating sushi\n";
+            LOG("Eating count : " << eating_counter);
+            LOG("Thread with " << std::this_thread::get_id() << " id eating sushi");
 
             mutex.lock();
             eating_counter--;
@@ -365,9 +366,24 @@ namespace not_remotely_classical_problems
         std::counting_semaphore<1> clear(0); // Ensures Dean leaves only after all students have left
         std::counting_semaphore<1> lie_in(0); // Rendezvous between student and the Dean (not explicitly used here)
 
-        void execute_dean()
+        /*
+         The Dean is stopped while waiting for a student. A student which signals lie_in or clear passes the mutex
+         to the Dean, so the Dean leaves only with the mutex : either passed with the signal, or taken while nobody
+         can signal any more. Otherwise the students would wait for the mutex forever.
+         */
+        void dean_leaves(std::counting_semaphore<1>& _signal)
+        {
+            while (!mutex.try_lock())
+            {
+                if (_signal.try_acquire()) { break; }
+            }
+            dean_state = not_here;
+            mutex.unlock();
+        }
+
+        void execute_dean(std::stop_token _token)
         {
-            while (1)
+            while (!_token.stop_requested())
             {
                 /*
                      When the Dean arrives, there are three cases: if there are students in the
@@ -385,9 +401,9 @@ namespace not_remotely_classical_problems
                 if (student_counter > 0 && student_counter < min_students_dean_enter_room)
                 {
                     dean_state = waiting;
-                    std::cout << "Dean is waiting in the party...\n";
+                    LOG("Dean is waiting in the party...");
                     mutex.unlock();
-                    lie_in.acquire();
+                    if (!scenario_runtime::acquire(lie_in, _token)) { dean_leaves(lie_in); return; }
                 }
 
                 // Students must be 0 or >= 50
@@ -395,17 +411,17 @@ namespace not_remotely_classical_problems
                 {
                     dean_state = in_the_room;
                     // break_up()
-                    std::cout << "Dean broke up the party and waiting for students to leave...\n";
+                    LOG("Dean broke up the party and waiting for students to leave...");
                     turn.lock();
                     mutex.unlock();
-                    clear.acquire();
+                    if (!scenario_runtime::acquire(clear, _token)) { dean_leaves(clear); turn.unlock(); return; }
                     turn.unlock();
                 }
                 else // Student count = 0
                 {
                     // search()
-                    std::cout << "Dean is searching the room...\n";
-                    std::cout << "Dean got out the room...\n";
+                    LOG("Dean is searching the room...");
+                    LOG("Dean got out the room...");
                 }
 
                 dean_state = not_here;
@@ -413,9 +429,9 @@ namespace not_remotely_classical_problems
             }
         }
 
-        void execute_student(const int& student_code)
+        void execute_student(std::stop_token _token, const int& student_code)
         {
-            while (1)
+            while (!_token.stop_requested())
             {
                 /*
                     There are three cases where a student might have to signal the Dean. If
@@ -452,7 +468,7 @@ namespace not_remotely_classical_problems
                     mutex.unlock();
                 }
 
-                std::cout << "Student has " << student_code << " number is partying...\n";
+                LOG("Student has " << student_code << " number is partying...");
 
                 mutex.lock();
 
@@ -473,18 +489,16 @@ namespace not_remotely_classical_problems
             }
         }
 
-        void run()
+        scenario_runtime::Statistics run(std::chrono::milliseconds _duration = scenario_runtime::forever)
         {
             constexpr int student_count = 250;
-            std::array<std::thread, student_count> students;
-
-            for (int i = 0; i < student_count; ++i) { students[i] = std::thread(execute_student, i); }
+            std::vector<std::jthread> threads;
 
-            std::thread dean(execute_dean);
+            for (int i = 0; i < student_count; ++i) { threads.emplace_back(execute_student, i); }
 
-            for (int i = 0; i < student_count; ++i) { if (students[i].joinable()) { students[i].join(); } }
+            threads.emplace_back(execute_dean);
 
-            if (dean.joinable()) { dean.join(); }
+            return scenario_runtime::run_for(_duration, threads);
         }
     }
 
@@ -519,28 +533,28 @@ namespace not_remotely_classical_problems
         std::counting_semaphore<total_bus_count> bus(0);
         std::counting_semaphore<total_rider_count> all_aboard(0);
 
-        void execute_bus()
+        void execute_bus(std::stop_token _token)
         {
             /*
                  When the bus arrives, it gets mutex, which prevents late arrivals from entering the boarding area.
                  If there are no riders, it departs immediately. Otherwise, it signals bus and waits for the riders to board
              */
-            while (true)
+            while (!_token.stop_requested())
             {
                 mutex.lock();
 
                 if (rider_count > 0)
                 {
                     bus.release();
-                    all_aboard.acquire();
+                    if (!scenario_runtime::acquire(all_aboard, _token)) { mutex.unlock(); return; }
                 }
                 mutex.unlock();
 
-                std::cout << "Bus is departing...\n";
+                LOG("Bus is departing...");
             }
         }
 
-        void execute_rider()
+        void execute_rider(std::stop_token _token)
         {
             /*
                 The multiplex controls the number of riders in the waiting area, although
@@ -553,16 +567,16 @@ namespace not_remotely_classical_problems
                 pass the mutex to the next rider. The last rider signals allAboard and passes
                 the mutex back to the bus. Finally, the bus releases the mutex and departs.
              */
-            while (true)
+            while (!_token.stop_requested())
             {
-                multiplex.acquire();
+                if (!scenario_runtime::acquire(multiplex, _token)) { return; }
                 mutex.lock();
                 rider_count++;
                 mutex.unlock();
-                bus.acquire();
+                if (!scenario_runtime::acquire(bus, _token)) { multiplex.release(); return; }
                 multiplex.release();
 
-                std::cout << "Boarding the bus...\n";
+                LOG("Boarding the bus...");
 
                 rider_count--;
 
@@ -577,16 +591,14 @@ namespace not_remotely_classical_problems
             }
         }
 
-        void run()
+        scenario_runtime::Statistics run(std::chrono::milliseconds _duration = scenario_runtime::forever)
         {
-            std::thread rider_threads[total_rider_count];
-            std::thread bus_threads[total_bus_count];
+            std::vector<std::jthread> threads;
 
-            for (int i = 0; i < total_bus_count; ++i) { bus_threads[i] = std::thread(execute_bus); }
-            for (int i = 0; i < total_rider_count; ++i) { rider_threads[i] = std::thread(execute_rider); }
+            for (int i = 0; i < total_bus_count; ++i) { threads.emplace_back(execute_bus); }
+            for (int i = 0; i < total_rider_count; ++i) { threads.emplace_back(execute_rider); }
 
-            for (auto& t : bus_threads) { if (t.joinable()) { t.join(); } }
-            for (auto& t : rider_threads) { if (t.joinable()) { t.join(); } }
+            return scenario_runtime::run_for(_duration, threads);
         }
     }
 
@@ -619,7 +631,7 @@ namespace not_remotely_classical_problems
         std::counting_semaphore<total_bus_count> bus(0); // signals when the bus has arrived
         std::counting_semaphore<max_rider_count_per_bus> boarded(0); // signals that a rider has boarded.
 
-        void execute_bus()
+        void execute_bus(std::stop_token _token)
         {
             /*
                 The bus gets the mutex and holds it throughout the boarding process. The
@@ -628,7 +640,7 @@ namespace not_remotely_classical_problems
                 When all the riders have boarded, the bus updates waiting, which is an
                 example of the “I’ll do it for you” pattern
              */
-            while (true)
+            while (!_token.stop_requested())
             {
                 mutex.lock();
 
@@ -637,42 +649,40 @@ namespace not_remotely_classical_problems
                 for (int i = 0; i < n; ++i)
                 {
                     bus.release();
-                    boarded.acquire();
+                    if (!scenario_runtime::acquire(boarded, _token)) { mutex.unlock(); return; }
                 }
 
                 waiting = std::max(waiting - max_rider_count_per_bus, 0);
                 mutex.unlock();
 
                 // depart()
-                std::cout << "Bus is departing...\n";
+                LOG("Bus is departing...");
             }
         }
 
-        void execute_rider()
+        void execute_rider(std::stop_token _token)
         {
-            while (true)
+            while (!_token.stop_requested())
             {
                 mutex.lock();
                 waiting++;
                 mutex.unlock();
 
-                bus.acquire();
+                if (!scenario_runtime::acquire(bus, _token)) { return; }
                 // board()
-                std::cout << "Boarding the bus...\n";
+                LOG("Boarding the bus...");
                 boarded.release();
             }
         }
 
-        void run()
+        scenario_runtime::Statistics run(std::chrono::milliseconds _duration = scenario_runtime::forever)
         {
-            std::thread rider_threads[total_rider_count];
-            std::thread bus_threads[total_bus_count];
+            std::vector<std::jthread> threads;
 
-            for (int i = 0; i < total_bus_count; ++i) { bus_threads[i] = std::thread(execute_bus); }
-            for (int i = 0; i < total_rider_count; ++i) { rider_threads[i] = std::thread(execute_rider); }
+            for (int i = 0; i < total_bus_count; ++i) { threads.emplace_back(execute_bus); }
+            for (int i = 0; i < total_rider_count; ++i) { threads.emplace_back(execute_rider); }
 
-            for (auto& t : bus_threads) { if (t.joinable()) { t.join(); } }
-            for (auto& t : rider_threads) { if (t.joinable()) { t.join(); } }
+            return scenario_runtime::run_for(_duration, threads);
         }
     }
 
@@ -731,12 +741,12 @@ namespace not_remotely_classical_problems
              */
 
             no_judge.lock();
-            std::cout << "Immigrant entered the room...\n"; // enter()
+            LOG("Immigrant entered the room..."); // enter()
             entered_immigrant++;
             no_judge.unlock();
 
             mutex.lock();
-            std::cout << "Immigrant checked in...\n"; // check();
+            LOG("Immigrant checked in..."); // check();
             checked_immigrant++;
 
             if (is_judge == 1 && entered_immigrant == checked_immigrant)
@@ -748,13 +758,13 @@ namespace not_remotely_classical_problems
                 mutex.unlock();
             }
 
-            std::cout << "Immigrant had a seat...\n"; // sit_down()
+            LOG("Immigrant had a seat..."); // sit_down()
             confirmed.acquire();
-            std::cout << "Immigrant sweared...\n"; // swear()
-            std::cout << "Immigrant got certificate...\n"; // get_certificate()
+            LOG("Immigrant sweared..."); // swear()
+            LOG("Immigrant got certificate..."); // get_certificate()
 
             no_judge.lock();
-            std::cout << "Immigrant is leaving...\n"; // leave()
+            LOG("Immigrant is leaving..."); // leave()
             no_judge.unlock();
 
         }
@@ -781,7 +791,7 @@ namespace not_remotely_classical_problems
             no_judge.lock();
             mutex.lock();
 
-            std::cout << "Judge entered the room...\n"; // enter()
+            LOG("Judge entered the room..."); // enter()
             is_judge = true;
 
             if (entered_immigrant > checked_immigrant)
@@ -789,13 +799,13 @@ namespace not_remotely_classical_problems
                 mutex.unlock();
                 all_signed_in.acquire();
             }
-            std::cout << "Judge confirmed all checked...\n"; // confirm()
+            LOG("Judge confirmed all checked..."); // confirm()
 
             confirmed.release(checked_immigrant);
             entered_immigrant = 0;
             checked_immigrant = 0;
 
-            std::cout << "Judge is leaving the room...\n" ;// leave()
+            LOG("Judge is leaving the room...");// leave()
             is_judge = false;
             mutex.unlock();
             no_judge.unlock();
@@ -803,11 +813,11 @@ namespace not_remotely_classical_problems
         void execute_spectator()
         {
             no_judge.lock();
-            std::cout << "Spectator entered the room...\n"; // enter()
+            LOG("Spectator entered the room..."); // enter()
             no_judge.unlock();
 
-            std::cout << "Spectator is spectating...\n" ;// spectate()
-            std::cout << "Spectator is leaving...\n" ;// leave()
+            LOG("Spectator is spectating...");// spectate()
+            LOG("Spectator is leaving...");// leave()
         }
         void run()
         {
@@ -873,13 +883,13 @@ namespace not_remotely_classical_problems
         {
             // Immigrants cannot enter while the judge is in the building
             no_judge.lock();
-            std::cout << "Immigrant entered the room...\n"; // enter()
+            LOG("Immigrant entered the room..."); // enter()
             entered_immigrant++;
             remaining_immigrants++; // Increment remaining immigrants in the building
             no_judge.unlock();
 
             mutex.lock();
-            std::cout << "Immigrant checked in...\n"; // checkIn()
+            LOG("Immigrant checked in..."); // checkIn()
             checked_immigrant++;
 
             if (is_judge && entered_immigrant == checked_immigrant)
@@ -891,13 +901,13 @@ namespace not_remotely_classical_problems
                 mutex.unlock();
             }
 
-            std::cout << "Immigrant had a seat...\n"; // sitDown()
+            LOG("Immigrant had a seat..."); // sitDown()
             confirmed.acquire();
-            std::cout << "Immigrant swore...\n"; // swear()
-            std::cout << "Immigrant got certificate...\n"; // getCertificate()
+            LOG("Immigrant swore..."); // swear()
+            LOG("Immigrant got certificate..."); // getCertificate()
 
             no_judge.lock();
-            std::cout << "Immigrant is leaving...\n"; // leave()
+            LOG("Immigrant is leaving..."); // leave()
             remaining_immigrants--; // Decrement remaining immigrants
             if (remaining_immigrants == 0)
             {
@@ -915,7 +925,7 @@ namespace not_remotely_classical_problems
             no_judge.lock();
             mutex.lock();
 
-            std::cout << "Judge entered the room...\n"; // enter()
+            LOG("Judge entered the room..."); // enter()
             is_judge = true;
 
             if (entered_immigrant > checked_immigrant)
@@ -924,12 +934,12 @@ namespace not_remotely_classical_problems
                 all_signed_in.acquire();
             }
 
-            std::cout << "Judge confirmed all checked...\n"; // confirm()
+            LOG("Judge confirmed all checked..."); // confirm()
             confirmed.release(checked_immigrant);
             entered_immigrant = 0;
             checked_immigrant = 0;
 
-            std::cout << "Judge is leaving the room...\n"; // leave()
+            LOG("Judge is leaving the room..."); // leave()
             is_judge = false;
             mutex.unlock();
             no_judge.unlock();
@@ -941,11 +951,11 @@ namespace not_remotely_classical_problems
         void execute_spectator()
         {
             no_judge.lock();
-            std::cout << "Spectator entered the room...\n"; // enter()
+            LOG("Spectator entered the room..."); // enter()
             no_judge.unlock();
 
-            std::cout << "Spectator is spectating...\n"; // spectate()
-            std::cout << "Spectator is leaving...\n"; // leave()
+            LOG("Spectator is spectating..."); // spectate()
+            LOG("Spectator is leaving..."); // leave()
         }
 
         void run()
@@ -1027,12 +1037,12 @@ namespace not_remotely_classical_problems
              */
 
             no_judge.lock();
-            std::cout << "Immigrant entered the room...\n"; // enter()
+            LOG("Immigrant entered the room..."); // enter()
             entered_immigrant++;
             no_judge.unlock();
 
             mutex.lock();
-            std::cout << "Immigrant checked in...\n"; // check();
+            LOG("Immigrant checked in..."); // check();
             checked_immigrant++;
 
             if (is_judge == 1 && entered_immigrant == checked_immigrant)
@@ -1044,13 +1054,13 @@ namespace not_remotely_classical_problems
                 mutex.unlock();
             }
 
-            std::cout << "Immigrant had a seat...\n"; // sit_down()
+            LOG("Immigrant had a seat..."); // sit_down()
             confirmed.acquire();
-            std::cout << "Immigrant sweared...\n"; // swear()
-            std::cout << "Immigrant got certificate...\n"; // get_certificate()
+            LOG("Immigrant sweared..."); // swear()
+            LOG("Immigrant got certificate..."); // get_certificate()
 
             exit.acquire();
-            std::cout << "Immigrant is leaving the room...\n" ;// leave()
+            LOG("Immigrant is leaving the room...");// leave()
             checked_immigrant--;
 
             if (checked_immigrant == 0)
@@ -1073,7 +1083,7 @@ namespace not_remotely_classical_problems
             no_judge.lock();
             mutex.lock();
 
-            std::cout << "Judge entered the room...\n"; // enter()
+            LOG("Judge entered the room..."); // enter()
             is_judge = true;
 
             if (entered_immigrant > checked_immigrant)
@@ -1081,12 +1091,12 @@ namespace not_remotely_classical_problems
                 mutex.unlock();
                 all_signed_in.acquire();
             }
-            std::cout << "Judge confirmed all checked...\n"; // confirm()
+            LOG("Judge confirmed all checked..."); // confirm()
 
             confirmed.release(checked_immigrant);
             entered_immigrant = 0;
 
-            std::cout << "Judge is leaving the room...\n" ;// leave()
+            LOG("Judge is leaving the room...");// leave()
             is_judge = false;
 
             exit.release();
@@ -1101,11 +1111,11 @@ namespace not_remotely_classical_problems
                 They simply need to pass through the no_judge turnstile to enter and exit.
             */
             no_judge.lock();
-            std::cout << "Spectator entered the room...\n"; // enter()
+            LOG("Spectator entered the room..."); // enter()
             no_judge.unlock();
 
-            std::cout << "Spectator is spectating...\n" ;// spectate()
-            std::cout << "Spectator is leaving...\n" ;// leave()
+            LOG("Spectator is spectating...");// spectate()
+            LOG("Spectator is leaving...");// leave()
         }
         void run()
         {
@@ -1158,7 +1168,7 @@ namespace not_remotely_classical_problems
 
         void execute(const int& student_code)
         {
-            std::cout << student_code << ". student is getting food...\n";
+            LOG(student_code << ". student is getting food...");
 
             mutex.lock();
             eating_counter++;
@@ -1171,7 +1181,7 @@ namespace not_remotely_classical_problems
 
             mutex.unlock();
 
-            std::cout << student_code << ". student is dining...\n";
+            LOG(student_code << ". student is dining...");
 
             mutex.lock();
             eating_counter--;
@@ -1194,7 +1204,7 @@ namespace not_remotely_classical_problems
                 mutex.unlock();
             }
 
-            std::cout << student_code << ". student is leaving...\n";
+            LOG(student_code << ". student is leaving...");
         }
         void run()
         {
@@ -1247,7 +1257,7 @@ namespace not_remotely_classical_problems
 
         void execute_student(const int& student_code)
         {
-            std::cout << student_code << ". student is getting food...\n";
+            LOG(student_code << ". student is getting food...");
 
             mutex.lock();
             ready_to_eat++;
@@ -1279,9 +1289,9 @@ namespace not_remotely_classical_problems
                 mutex.unlock();
             }
 
-            std::cout << student_code << ". student is dining...\n";
+            LOG(student_code << ". student is dining...");
 
-            std::this_thread::sleep_for(std::chrono::seconds(1));
+            scenario_runtime::pause(std::chrono::seconds(1));
 
             mutex.lock();
             eating--;
@@ -1306,7 +1316,7 @@ namespace not_remotely_classical_problems
                 mutex.unlock();
             }
 
-            std::cout << student_code << ". student is leaving...\n";
+            LOG(student_code << ". student is leaving...");
         }
 
         void run()
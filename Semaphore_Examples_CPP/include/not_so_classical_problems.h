@@ -5,46 +5,20 @@
 #ifndef SEMAPHORE_EXAMPLES_CPP_NOT_SO_CLASSICAL_PROBLEMS_H
 #define SEMAPHORE_EXAMPLES_CPP_NOT_SO_CLASSICAL_PROBLEMS_H
 
-#include <iostream>
 #include <mutex>
 #include <thread>
 #include <array>
 #include <list>
+#include <vector>
 #include "single_linked_list.h"
+#include "Lightswitch.h"
+#include "ConcurrentOrderedList.h"
+#include "fast_random.h"
+#include "LogSink.h"
+#include "scenario_runtime.h"
 
 namespace not_so_classical_problems
 {
-    class Lightswitch
-    {
-    public:
-        Lightswitch() : counter(0) {}
-
-        void lock(std::mutex& _roomEmpty)
-        {
-            mutex.lock();
-            counter++;
-            if (counter == 1)
-            {
-                _roomEmpty.lock();
-            }
-            mutex.unlock();
-        }
-
-        void unlock(std::mutex& _roomEmpty)
-        {
-            mutex.lock();
-            counter--;
-            if (counter == 0)
-            {
-                _roomEmpty.unlock();
-            }
-            mutex.unlock();
-        }
-    private:
-        int counter;
-        std::mutex mutex;
-    };
-
     namespace  search_insert_delete_problem
     {
         // To show properly how it is running, added single linked list to the problem.
@@ -77,90 +51,113 @@ namespace not_so_classical_problems
                 16 could not find in the list by searching...
                 10 could not find in the list for deleting...
                 24 is inserted to the list...
+
+            - CONCURRENT LIST !!
+                The categorical exclusion above is what the book asks for, but it makes every deleter wait until
+                no searcher and no inserter is in the list, and the other way around. With CONCURRENT_LIST the
+                threads share a ConcurrentOrderedList instead. It only locks the two nodes around an insert or a
+                delete, so searchers, inserters and deleters work on the list at the same time and only meet when
+                they touch the same nodes. The list is a sorted set, inserting a value twice does nothing.
          */
 
+        #define CONCURRENT_LIST 1
+
         // GLOBAL VARIABLES
+        #if CONCURRENT_LIST
+        ConcurrentOrderedList concurrent_list;
+        #else
         std::mutex insert_mutex;
-        std::mutex no_searcher;
-        std::mutex no_inserter;
-        Lightswitch search_switch;
-        Lightswitch insert_switch;
+        // Rooms of the lightswitches : the last searcher / inserter out releases them, which may be another thread
+        // than the first one in. A std::mutex must be unlocked by its owner, a semaphore may be released by anybody.
+        std::binary_semaphore no_searcher(1);
+        std::binary_semaphore no_inserter(1);
+        Lightswitch<> search_switch(no_searcher);
+        Lightswitch<> insert_switch(no_inserter);
         SinglyLinkedList test_list;
+        #endif
 
-        void execute_searcher()
+        void execute_searcher(std::stop_token _token)
         {
-            while (true)
+            while (!_token.stop_requested())
             {
-                search_switch.lock(no_searcher);
-                // CRITICAL SECTION
-                std::random_device rd;
-                std::mt19937 gen(rd());
-                std::uniform_int_distribution<> dis(0, 50);
+            #if CONCURRENT_LIST
+                int searching_value = random_int(0, 50);
+                bool is_found = concurrent_list.contains(searching_value);
 
-                int searching_value = dis(gen);
-                bool is_found = test_list.search(searching_value);
-
-                if (is_found) { std::cout << searching_value << " exists in the list...\n"; }
-                else { std::cout << searching_value << " could not find in the list by searching...\n"; }
+                if (is_found) { LOG(searching_value << " exists in the list..."); }
+                else { LOG(searching_value << " could not find in the list by searching..."); }
+            #else
+                {
+                    ScopedLightswitch searching(search_switch); // the last searcher out lets the deleters in
+                    // CRITICAL SECTION
+                    int searching_value = random_int(0, 50);
+                    bool is_found = test_list.search(searching_value);
 
-                search_switch.unlock(no_searcher);
-                std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+                    if (is_found) { LOG(searching_value << " exists in the list..."); }
+                    else { LOG(searching_value << " could not find in the list by searching..."); }
+                }
+            #endif
+                scenario_runtime::pause(std::chrono::milliseconds(1000), _token);
             }
         }
-        void execute_inserter()
+        void execute_inserter(std::stop_token _token)
         {
-            while (true)
+            while (!_token.stop_requested())
             {
-                insert_switch.lock(no_inserter);
-                insert_mutex.lock();
-                // CRITICAL SECTION
-                std::random_device rd;
-                std::mt19937 gen(rd());
-                std::uniform_int_distribution<> dis(0, 50);
-
-                int appending_value = dis(gen);
-                test_list.append(appending_value);
+            #if CONCURRENT_LIST
+                int appending_value = random_int(0, 50);
+                bool is_inserted = concurrent_list.insert(appending_value);
 
-                std::cout << appending_value << " is inserted to the list...\n";
+                if (is_inserted) { LOG(appending_value << " is inserted to the list..."); }
+                else { LOG(appending_value << " is already in the list..."); }
+            #else
+                {
+                    ScopedLightswitch inserting(insert_switch); // the last inserter out lets the deleters in
+                    std::lock_guard<std::mutex> lock(insert_mutex);
+                    // CRITICAL SECTION
+                    int appending_value = random_int(0, 50);
+                    test_list.append(appending_value);
 
-                insert_mutex.unlock();
-                insert_switch.unlock(no_inserter);
-                std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+                    LOG(appending_value << " is inserted to the list...");
+                }
+            #endif
+                scenario_runtime::pause(std::chrono::milliseconds(1000), _token);
             }
         }
-        void execute_deleter()
+        void execute_deleter(std::stop_token _token)
         {
-            while (true)
+            while (!_token.stop_requested())
             {
-                no_searcher.lock();
-                no_inserter.lock();
+            #if CONCURRENT_LIST
+                int deleting_value = random_int(0, 50);
+                bool is_deleted = concurrent_list.remove(deleting_value);
+            #else
+                if (!scenario_runtime::acquire(no_searcher, _token)) { return; }
+                if (!scenario_runtime::acquire(no_inserter, _token)) { no_searcher.release(); return; }
                 // CRITICAL SECTION
-                std::random_device rd;
-                std::mt19937 gen(rd());
-                std::uniform_int_distribution<> dis(0, 50);
-
-                int deleting_value = dis(gen);
+                int deleting_value = random_int(0, 50);
                 bool is_deleted = test_list.deleteValue(deleting_value);
+            #endif
 
-                if (is_deleted) { std::cout << deleting_value << " is deleted from the list...\n"; }
-                else { std::cout << deleting_value << " could not find in the list for deleting...\n"; }
+                if (is_deleted) { LOG(deleting_value << " is deleted from the list..."); }
+                else { LOG(deleting_value << " could not find in the list for deleting..."); }
 
-                no_inserter.unlock();
-                no_searcher.unlock();
-                std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+            #if !CONCURRENT_LIST
+                no_inserter.release();
+                no_searcher.release();
+            #endif
+                scenario_runtime::pause(std::chrono::milliseconds(1000), _token);
             }
         }
 
-        void run()
+        scenario_runtime::Statistics run(std::chrono::milliseconds _duration = scenario_runtime::forever)
         {
-            constexpr int thread_amount = 3;
-            std::array<std::thread, thread_amount> threads {
-                    std::thread(execute_searcher),
-                    std::thread(execute_inserter),
-                    std::thread(execute_deleter)
-            };
-
-            for(auto& thread : threads) { if (thread.joinable()) { thread.join(); } }
+            std::vector<std::jthread> threads;
+            threads.emplace_back(execute_searcher);
+            threads.emplace_back(execute_inserter);
+            threads.emplace_back(execute_deleter);
+
+            return scenario_runtime::run_for(_duration, threads);
         }
     }
 
@@ -215,53 +212,55 @@ namespace not_so_classical_problems
                 As you can see in the output, women can very often enter the bathroom and prevent men from entering.
          */
 
-        std::mutex empty; // empty is 1 (unlock) if the room is empty and 0 (lock) otherwise.
-        Lightswitch maleSwitch;
-        Lightswitch femaleSwitch;
+        // empty is 1 if the room is empty and 0 otherwise. The last one out releases it, which may be another thread
+        // than the first one in, so it is a semaphore : a std::mutex must be unlocked by the thread which locked it.
+        std::binary_semaphore empty(1);
+        Lightswitch<> maleSwitch(empty);
+        Lightswitch<> femaleSwitch(empty);
         // ATTENTION : men and women cannot get in at the same time
         std::counting_semaphore<3> maleMultiplex(3); // 3 men can get in at the same time
         std::counting_semaphore<3> femaleMultiplex(3); // 3 women can get in at the same time
 
-        void execute_male()
+        void execute_male(std::stop_token _token)
         {
-            while (true)
+            while (!_token.stop_requested())
             {
-                maleSwitch.lock(empty);
-                maleMultiplex.acquire();
-                // bathroom code here
-                std::cout << "A male has entered to the bathroom\n";
-                maleMultiplex.release();
-                maleSwitch.unlock(empty);
-                std::this_thread::sleep_for(std::chrono::milliseconds(500));
+                {
+                    ScopedLightswitch in_bathroom(maleSwitch);
+                    if (!scenario_runtime::acquire(maleMultiplex, _token)) { return; }
+                    // bathroom code here
+                    LOG("A male has entered to the bathroom");
+                    maleMultiplex.release();
+                }
+                scenario_runtime::pause(std::chrono::milliseconds(500), _token);
             }
         }
 
-        void execute_female()
+        void execute_female(std::stop_token _token)
         {
-            while (true)
+            while (!_token.stop_requested())
             {
-                femaleSwitch.lock(empty);
-                femaleMultiplex.acquire();
-                // bathroom code here
-                std::cout << "A female has entered to the bathroom\n";
-                femaleMultiplex.release();
-                femaleSwitch.unlock(empty);
-                std::this_thread::sleep_for(std::chrono::milliseconds(500));
+                {
+                    ScopedLightswitch in_bathroom(femaleSwitch);
+                    if (!scenario_runtime::acquire(femaleMultiplex, _token)) { return; }
+                    // bathroom code here
+                    LOG("A female has entered to the bathroom");
+                    femaleMultiplex.release();
+                }
+                scenario_runtime::pause(std::chrono::milliseconds(500), _token);
             }
         }
 
-        void run()
+        scenario_runtime::Statistics run(std::chrono::milliseconds _duration = scenario_runtime::forever)
         {
-            constexpr int female_number = 5;
-            constexpr int male_number = 5;
-            std::array<std::thread, female_number>  females;
-            std::array<std::thread, male_number>    males;
+            const int female_number = scenario_runtime::thread_count(5);
+            const int male_number = scenario_runtime::thread_count(5);
+            std::vector<std::jthread> threads;
 
-            for (int i = 0; i < male_number; ++i) { males[i] = std::thread(execute_male); }
-            for (int i = 0; i < female_number; ++i) { females[i] = std::thread(execute_female); }
+            for (int i = 0; i < male_number; ++i) { threads.emplace_back(execute_male); }
+            for (int i = 0; i < female_number; ++i) { threads.emplace_back(execute_female); }
 
-            for (auto& male : males) { if (male.joinable()) { male.join(); }}
-            for (auto& female : females) { if (female.joinable()) { female.join(); }}
+            return scenario_runtime::run_for(_duration, threads);
         }
     }
 
@@ -288,60 +287,62 @@ namespace not_so_classical_problems
                 ...
          */
 
-        std::mutex empty; // empty is 1 (unlock) if the room is empty and 0 (lock) otherwise.
-        Lightswitch maleSwitch;
-        Lightswitch femaleSwitch;
+        // empty is 1 if the room is empty and 0 otherwise. The last one out releases it, which may be another thread
+        // than the first one in, so it is a semaphore : a std::mutex must be unlocked by the thread which locked it.
+        std::binary_semaphore empty(1);
+        Lightswitch<> maleSwitch(empty);
+        Lightswitch<> femaleSwitch(empty);
         // ATTENTION : men and women cannot get in at the same time
         std::counting_semaphore<3> maleMultiplex(3); // 3 men can get in at the same time
         std::counting_semaphore<3> femaleMultiplex(3); // 3 women can get in at the same time
         std::mutex turnstile;
 
-        void execute_male()
+        void execute_male(std::stop_token _token)
         {
-            while (true)
+            while (!_token.stop_requested())
             {
-                turnstile.lock();
-                maleSwitch.lock(empty);
-                turnstile.unlock();
-
-                maleMultiplex.acquire();
-                // bathroom code here
-                std::cout << "A male has entered to the bathroom\n";
-                maleMultiplex.release();
-                maleSwitch.unlock(empty);
-                std::this_thread::sleep_for(std::chrono::milliseconds(500));
+                {
+                    turnstile.lock();
+                    ScopedLightswitch in_bathroom(maleSwitch);
+                    turnstile.unlock();
+
+                    if (!scenario_runtime::acquire(maleMultiplex, _token)) { return; }
+                    // bathroom code here
+                    LOG("A male has entered to the bathroom");
+                    maleMultiplex.release();
+                }
+                scenario_runtime::pause(std::chrono::milliseconds(500), _token);
             }
         }
 
-        void execute_female()
+        void execute_female(std::stop_token _token)
         {
-            while (true)
+            while (!_token.stop_requested())
             {
-                turnstile.lock();
-                femaleSwitch.lock(empty);
-                turnstile.unlock();
-
-                femaleMultiplex.acquire();
-                // bathroom code here
-                std::cout << "A female has entered to the bathroom\n";
-                femaleMultiplex.release();
-                femaleSwitch.unlock(empty);
-                std::this_thread::sleep_for(std::chrono::milliseconds(500));
+                {
+                    turnstile.lock();
+                    ScopedLightswitch in_bathroom(femaleSwitch);
+                    turnstile.unlock();
+
+                    if (!scenario_runtime::acquire(femaleMultiplex, _token)) { return; }
+                    // bathroom code here
+                    LOG("A female has entered to the bathroom");
+                    femaleMultiplex.release();
+                }
+                scenario_runtime::pause(std::chrono::milliseconds(500), _token);
             }
         }
 
-        void run()
+        scenario_runtime::Statistics run(std::chrono::milliseconds _duration = scenario_runtime::forever)
         {
-            constexpr int female_number = 5;
-            constexpr int male_number = 5;
-            std::array<std::thread, female_number>  females;
-            std::array<std::thread, male_number>    males;
+            const int female_number = scenario_runtime::thread_count(5);
+            const int male_number = scenario_runtime::thread_count(5);
+            std::vector<std::jthread> threads;
 
-            for (int i = 0; i < male_number; ++i) { males[i] = std::thread(execute_male); }
-            for (int i = 0; i < female_number; ++i) { females[i] = std::thread(execute_female); }
+            for (int i = 0; i < male_number; ++i) { threads.emplace_back(execute_male); }
+            for (int i = 0; i < female_number; ++i) { threads.emplace_back(execute_female); }
 
-            for (auto& male : males) { if (male.joinable()) { male.join(); }}
-            for (auto& female : females) { if (female.joinable()) { female.join(); }}
+            return scenario_runtime::run_for(_duration, threads);
         }
     }
 
@@ -467,7 +468,7 @@ namespace not_so_classical_problems
                     mutex.unlock();
             }
 
-            std::cout << "Heathen is crossing the field.\n";
+            LOG("Heathen is crossing the field.");
 
             mutex.lock();
             heathen_counter--;
@@ -530,7 +531,7 @@ namespace not_so_classical_problems
                     mutex.unlock();
             }
 
-            std::cout << "Prude is crossing the field.\n";
+            LOG("Prude is crossing the field.");
 
             mutex.lock();
             prude_counter--;
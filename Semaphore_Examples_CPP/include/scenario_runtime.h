@@ -0,0 +1,277 @@
+//
+// Created by agent on 10/17/2026.
+//
+
+#ifndef SEMAPHORE_EXAMPLES_CPP_SCENARIO_RUNTIME_H
+#define SEMAPHORE_EXAMPLES_CPP_SCENARIO_RUNTIME_H
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <stop_token>
+#include <thread>
+#include <vector>
+
+/*
+ - WHAT IS THIS !!
+    The few knobs the scenarios share, so the same run() can be watched in the terminal (main.cpp) or measured by
+    the benchmark harness (bench_main.cpp) :
+
+    pause(duration)      : the sleeps of the scenarios. The harness turns them off, then a scenario runs as fast
+                           as its synchronization allows.
+    thread_count(n)      : worker count of the scenarios which have a natural pool of workers. Returns n unless
+                           the harness asked for another count.
+    acquire(s, token)    : blocking acquire which gives up when the scenario is stopped (see COOPERATIVE SHUTDOWN).
+                           While the harness measures, the time from the call until the semaphore is ours goes
+                           into the acquire wait histogram of the thread.
+    run_for(d, threads)  : lets the threads of a scenario run for a duration, stops them and returns the statistics.
+    step()               : one action of a scenario (an event processed, a customer got a hair cut, ...).
+                           Every LOG line of a scenario is a step, so the scenarios do not call it themselves.
+                           While the harness measures, step() counts the action and records the time since the
+                           previous step of the same thread into the step latency histogram.
+
+    Waits which do not go through acquire (a mutex.lock(), a plain semaphore.acquire()) are only visible in the step
+    latency.
+
+ - COOPERATIVE SHUTDOWN !!
+    The looping scenarios run on std::jthread and check their std::stop_token on every round. A thread which is
+    blocked on a semaphore would never see the token, so the scenarios wait with acquire(semaphore, token) : a
+    timed acquire in a loop which returns false once a stop is requested. Then the thread leaves its loop, the
+    threads which wait for it give up the same way and everybody can be joined.
+    The state of a stopped scenario (semaphore counts, buffers) is not reset, a scenario runs once per process.
+
+ - WHY SHARDS !!
+    step() is called from every thread of a scenario. One shared counter would be a cache line which all threads
+    write, and the harness would measure that cache line instead of the scenario. Each thread writes into one of
+    "shardCount" cache-line aligned shards, the harness adds them up at the end.
+ */
+
+namespace scenario_runtime
+{
+    inline std::atomic<bool> sleepsEnabled{true};
+    inline std::atomic<int> threadOverride{0}; // 0 : every scenario uses its own worker count
+    inline std::atomic<bool> measuring{false};
+
+    constexpr std::chrono::milliseconds forever = std::chrono::milliseconds::max();
+    // How long a cancellable wait sleeps before it looks at the stop token again.
+    constexpr std::chrono::milliseconds stopPollInterval{10};
+
+    inline void pause(std::chrono::milliseconds _duration)
+    {
+        if (sleepsEnabled.load(std::memory_order_relaxed)) { std::this_thread::sleep_for(_duration); }
+    }
+
+    // Same as pause, but wakes up as soon as the scenario is stopped.
+    inline void pause(std::chrono::milliseconds _duration, const std::stop_token& _token)
+    {
+        if (!sleepsEnabled.load(std::memory_order_relaxed)) { return; }
+
+        std::mutex mutex;
+        std::condition_variable_any wakeUp;
+        std::unique_lock<std::mutex> lock(mutex);
+        wakeUp.wait_for(lock, _token, _duration, [] { return false; });
+    }
+
+    inline int thread_count(int _default)
+    {
+        const int requested = threadOverride.load(std::memory_order_relaxed);
+        return requested > 0 ? requested : _default;
+    }
+
+    /*
+     Log-linear histogram of nanoseconds : every power of two is split into 8 sub-buckets, so a recorded value is
+     off by at most 12.5% and the whole uint64_t range fits into 496 counters. Recording is one relaxed fetch_add.
+     */
+    class LatencyHistogram
+    {
+    public:
+        static constexpr int subBucketBits = 3;
+        static constexpr int subBuckets = 1 << subBucketBits;
+        static constexpr int bucketCount = (64 - subBucketBits + 1) * subBuckets;
+
+        static int bucket_of(uint64_t _value)
+        {
+            if (_value < subBuckets) { return static_cast<int>(_value); }
+            const int exponent = std::bit_width(_value) - 1;
+            const int subBucket = static_cast<int>(_value >> (exponent - subBucketBits)) & (subBuckets - 1);
+            return (exponent - subBucketBits + 1) * subBuckets + subBucket;
+        }
+
+        // Smallest value which falls into the bucket.
+        static uint64_t lowest_of(int _bucket)
+        {
+            if (_bucket < subBuckets) { return static_cast<uint64_t>(_bucket); }
+            const int exponent = _bucket / subBuckets + subBucketBits - 1;
+            const uint64_t subBucket = static_cast<uint64_t>(_bucket % subBuckets);
+            return (uint64_t{1} << exponent) | (subBucket << (exponent - subBucketBits));
+        }
+
+        void record(uint64_t _value) { counts[bucket_of(_value)].fetch_add(1, std::memory_order_relaxed); }
+
+        uint64_t count(int _bucket) const { return counts[_bucket].load(std::memory_order_relaxed); }
+
+        // Lowest value of the bucket which contains the _percent percentile, 0 without samples.
+        uint64_t percentile(double _percent) const
+        {
+            uint64_t samples = 0;
+            for (int i = 0; i < bucketCount; ++i) { samples += count(i); }
+
+            uint64_t seen = 0;
+            for (int i = 0; i < bucketCount && samples > 0; ++i)
+            {
+                seen += count(i);
+                if (seen * 100.0 >= samples * _percent) { return lowest_of(i); }
+            }
+            return 0;
+        }
+
+        void reset()
+        {
+            for (auto& counter : counts) { counter.store(0, std::memory_order_relaxed); }
+        }
+
+    private:
+        std::array<std::atomic<uint64_t>, bucketCount> counts{};
+    };
+
+    constexpr int shardCount = 16;
+
+    struct alignas(64) Shard
+    {
+        std::atomic<uint64_t> steps{0};
+        LatencyHistogram latency;     // time between two steps of a thread
+        LatencyHistogram acquireWait; // time a thread waited in acquire(s, token)
+    };
+
+    inline std::array<Shard, shardCount> shards;
+    inline std::atomic<int> nextShard{0};
+
+    inline Shard& this_thread_shard()
+    {
+        thread_local Shard& shard = shards[nextShard.fetch_add(1, std::memory_order_relaxed) % shardCount];
+        return shard;
+    }
+
+    inline uint64_t nanoseconds_since(std::chrono::steady_clock::time_point _start)
+    {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - _start).count());
+    }
+
+    inline void step()
+    {
+        if (!measuring.load(std::memory_order_relaxed)) { return; }
+
+        Shard& shard = this_thread_shard();
+        thread_local std::chrono::steady_clock::time_point previous{};
+
+        const auto now = std::chrono::steady_clock::now();
+        shard.steps.fetch_add(1, std::memory_order_relaxed);
+        if (previous != std::chrono::steady_clock::time_point{})
+        {
+            shard.latency.record(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(now - previous).count()));
+        }
+        previous = now;
+    }
+
+    // Returns false, without a token, when the scenario is stopped while waiting.
+    template <typename Semaphore>
+    bool acquire(Semaphore& _semaphore, const std::stop_token& _token)
+    {
+        // Only read the clock while the harness measures, the terminal runs do not pay for it.
+        const bool timed = measuring.load(std::memory_order_relaxed);
+        const auto start = timed ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point{};
+
+        while (!_semaphore.try_acquire_for(stopPollInterval))
+        {
+            if (_token.stop_requested()) { return false; } // a wait which was given up is not an acquire
+        }
+
+        if (timed) { this_thread_shard().acquireWait.record(nanoseconds_since(start)); }
+        return true;
+    }
+
+    struct Statistics
+    {
+        uint64_t steps = 0;
+        uint64_t stepP50Ns = 0;
+        uint64_t stepP99Ns = 0;
+        uint64_t acquireP50Ns = 0;
+        uint64_t acquireP99Ns = 0;
+        double seconds = 0;
+    };
+
+    inline void reset()
+    {
+        for (Shard& shard : shards)
+        {
+            shard.steps.store(0, std::memory_order_relaxed);
+            shard.latency.reset();
+            shard.acquireWait.reset();
+        }
+    }
+
+    // p50 and p99 of one histogram of every shard, added up. Percentiles are the lowest value of the bucket which contains them.
+    inline void merged_percentiles(LatencyHistogram Shard::* _histogram, uint64_t& _p50, uint64_t& _p99)
+    {
+        std::array<uint64_t, LatencyHistogram::bucketCount> merged{};
+        uint64_t samples = 0;
+
+        for (const Shard& shard : shards)
+        {
+            for (int i = 0; i < LatencyHistogram::bucketCount; ++i)
+            {
+                merged[i] += (shard.*_histogram).count(i);
+                samples += (shard.*_histogram).count(i);
+            }
+        }
+
+        uint64_t seen = 0;
+        for (int i = 0; i < LatencyHistogram::bucketCount && samples > 0; ++i)
+        {
+            const bool belowP50 = seen * 100 < samples * 50;
+            const bool belowP99 = seen * 100 < samples * 99;
+            seen += merged[i];
+            if (belowP50 && seen * 100 >= samples * 50) { _p50 = LatencyHistogram::lowest_of(i); }
+            if (belowP99 && seen * 100 >= samples * 99) { _p99 = LatencyHistogram::lowest_of(i); }
+        }
+    }
+
+    inline Statistics collect()
+    {
+        Statistics statistics;
+        for (const Shard& shard : shards) { statistics.steps += shard.steps.load(std::memory_order_relaxed); }
+        merged_percentiles(&Shard::latency, statistics.stepP50Ns, statistics.stepP99Ns);
+        merged_percentiles(&Shard::acquireWait, statistics.acquireP50Ns, statistics.acquireP99Ns);
+        return statistics;
+    }
+
+    /*
+     Measures the scenario while its threads run. With "forever" it only joins them, like the scenarios did before.
+     Otherwise it requests a stop after _duration and joins the threads, which leave their loops at the next round
+     or at the next cancellable acquire.
+     */
+    inline Statistics run_for(std::chrono::milliseconds _duration, std::vector<std::jthread>& _threads)
+    {
+        reset();
+        measuring.store(true, std::memory_order_relaxed);
+        const auto start = std::chrono::steady_clock::now();
+
+        if (_duration != forever)
+        {
+            std::this_thread::sleep_for(_duration);
+            for (auto& thread : _threads) { thread.request_stop(); }
+        }
+        for (auto& thread : _threads) { if (thread.joinable()) { thread.join(); } }
+
+        measuring.store(false, std::memory_order_relaxed);
+        Statistics statistics = collect();
+        statistics.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        return statistics;
+    }
+}
+
+#endif //SEMAPHORE_EXAMPLES_CPP_SCENARIO_RUNTIME_H
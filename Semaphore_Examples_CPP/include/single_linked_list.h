@@ -6,37 +6,98 @@
 #define SEMAPHORE_EXAMPLES_CPP_SINGLE_LINKED_LIST_H
 
 #include <iostream>
+#include <memory>
+#include <vector>
 
 struct Node {
     int data;
     Node* next;
 
-    Node(int val) : data(val), next(nullptr) {}
+    Node(int val = 0) : data(val), next(nullptr) {}
+};
+
+/*
+ - WHY A NODE POOL !!
+    With a new for every node, the nodes of a list end up all over the heap and a search misses the cache on
+    almost every node. The pool carves nodes out of slabs of "slabSize" neighbour nodes, so nodes which were
+    appended one after another are also next to each other in memory. Deleted nodes go to a free list and the
+    next append takes them from there, nothing is given back to the heap until the list is destroyed.
+
+ - PAY ATTENTION !!
+    The pool is not thread-safe, it is guarded by the same locks as the list.
+ */
+class NodePool {
+public:
+    Node* allocate(int val)
+    {
+        Node* node = freeList;
+        if (node)
+        {
+            freeList = node->next;
+        }
+        else
+        {
+            if (slabs.empty() || used == slabSize)
+            {
+                slabs.push_back(std::make_unique<Node[]>(slabSize));
+                used = 0;
+            }
+            node = &slabs.back()[used++];
+        }
+
+        node->data = val;
+        node->next = nullptr;
+        return node;
+    }
+
+    void release(Node* node)
+    {
+        node->next = freeList;
+        freeList = node;
+    }
+
+private:
+    static constexpr int slabSize = 1024; // nodes per slab, 16 KB
+
+    std::vector<std::unique_ptr<Node[]>> slabs;
+    int used = 0; // nodes taken from the last slab
+    Node* freeList = nullptr;
 };
 
 class SinglyLinkedList {
 private:
     Node* head;
+    Node* tail;
+    int count;
+    NodePool pool;
 
 public:
-    SinglyLinkedList() : head(nullptr) {}
+    SinglyLinkedList() : head(nullptr), tail(nullptr), count(0) {}
+    SinglyLinkedList(const SinglyLinkedList&) = delete;
+    SinglyLinkedList& operator=(const SinglyLinkedList&) = delete;
 
     void append(int val)
     {
-        Node* newNode = new Node(val);
+        Node* newNode = pool.allocate(val);
         if (!head)
         {
             head = newNode;
         }
         else
         {
-            Node* current = head;
-            while (current->next)
-            {
-                current = current->next;
-            }
-            current->next = newNode;
+            tail->next = newNode;
         }
+        tail = newNode;
+        count++;
+    }
+
+    void prepend(int val)
+    {
+        Node* newNode = pool.allocate(val);
+        newNode->next = head;
+        head = newNode;
+        if (!tail) { tail = newNode; }
+        count++;
     }
 
     bool search(int val)
@@ -61,7 +122,9 @@ public:
         {
             Node* temp = head;
             head = head->next;
-            delete temp;
+            if (!head) { tail = nullptr; }
+            pool.release(temp);
+            count--;
             return true;
         }
 
@@ -75,7 +138,9 @@ public:
         {
             Node* temp = current->next;
             current->next = current->next->next;
-            delete temp;
+            if (temp == tail) { tail = current; }
+            pool.release(temp);
+            count--;
             return true;
         }
 
@@ -95,26 +160,11 @@ public:
 
     int size()
     {
-        int count = 0;
-        Node* current = head;
-        while (current)
-        {
-            count++;
-            current = current->next;
-        }
         return count;
     }
 
-    ~SinglyLinkedList()
-    {
-        Node* current = head;
-        while (current)
-        {
-            Node* next = current->next;
-            delete current;
-            current = next;
-        }
-    }
+    // The nodes belong to the slabs of the pool, they are freed with it.
+    ~SinglyLinkedList() = default;
 };
 
 #endif //SEMAPHORE_EXAMPLES_CPP_SINGLE_LINKED_LIST_H
@@ -0,0 +1,31 @@
+//
+// Created by agent on 10/17/2026.
+//
+
+#ifndef SEMAPHORE_EXAMPLES_CPP_SPIN_WAIT_H
+#define SEMAPHORE_EXAMPLES_CPP_SPIN_WAIT_H
+
+#include <thread>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#include <immintrin.h>
+#endif
+
+/*
+ - WHY A PAUSE INSTRUCTION !!
+ While a thread is busy-waiting on a shared variable, the pause (x86) / yield (ARM) hint tells the core
+ that this is a spin loop. The core slows the loop down, saves power and does not flood the memory bus
+ with speculative loads of the same cache line. On other platforms we simply give the time slice back.
+ */
+inline void cpu_relax()
+{
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+    _mm_pause();
+#elif defined(__aarch64__) && (defined(__GNUC__) || defined(__clang__))
+    asm volatile("yield");
+#else
+    std::this_thread::yield();
+#endif
+}
+
+#endif //SEMAPHORE_EXAMPLES_CPP_SPIN_WAIT_H
@@ -4,6 +4,7 @@
 #include "include/less_classical_synchronization_problems.h"
 #include "include/not_so_classical_problems.h"
 #include "include/not_remotely_classical_problems.h"
+#include "include/benchmarks.h"
 
 using namespace introduction;
 using namespace basic_synchronization_patterns;
@@ -11,6 +12,7 @@ using namespace classical_synchronization_problems;
 using namespace less_classical_synchronization_problems;
 using namespace not_so_classical_problems;
 using namespace not_remotely_classical_problems;
+using namespace benchmarks;
 
 int main()
 {
@@ -74,5 +76,24 @@ int main()
 //    dining_hall_problem::run();
 //    extended_dining_hall_problem::run();
 
+    // BENCHMARKS
+//    barrier_benchmark::run();
+//    producer_consumer_benchmark::run();
+//    bulk_transfer_benchmark::run();
+//    event_allocation_benchmark::run();
+//    random_event_benchmark::run();
+//    logging_benchmark::run();
+//    rw_mix_benchmark::run();
+//    rw_policy_benchmark::run();
+//    ordered_list_benchmark::run();
+//    reclamation_benchmark::run();
+//    lightswitch_benchmark::run();
+//    handoff_benchmark::run();
+//    exchanger_benchmark::run();
+//    dining_benchmark::run();
+//    join_matcher_benchmark::run();
+//    savages_benchmark::run();
+//    wait_queue_benchmark::run();
+
     return 0;
 }
\ No newline at end of file
@@ -3,37 +3,214 @@
 //
 
 #include "../include/Barrier.h"
+#include "../include/spin_wait.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
 
-Barrier::Barrier(int _n) :
+namespace
+{
+    std::atomic<uint64_t> nextBarrierId{0};
+
+    // Misuse which would corrupt the barrier : stop right away, in release builds too (an assert is compiled out).
+    [[noreturn]] void misuse(const char* _message)
+    {
+        std::fprintf(stderr, "Barrier : %s\n", _message);
+        std::abort();
+    }
+}
+
+Barrier::Barrier(int _n, EBarrierPolicy _policy) :
         n(_n),
         count(0),
+        policy(_policy),
         mutex(1),
         turnstile(0),
-        turnstile2(0)
-{}
+        turnstile2(0),
+        id(nextBarrierId.fetch_add(1, std::memory_order_relaxed)),
+        registered(0),
+        state(0)
+{
+    if (n <= 0) { misuse("a barrier needs at least one thread"); }
+    // The arrivals are counted in the low 16 bits of the state word, one more would carry into the generation.
+    if (policy != EBarrierPolicy::turnstile && static_cast<uint32_t>(n) > arrivedMask)
+    {
+        misuse("generation and combining_tree barriers take at most 65535 threads");
+    }
+
+    if (policy == EBarrierPolicy::combining_tree) { build_tree(); }
+}
 
 void Barrier::phase1()
+{
+    switch (policy)
+    {
+        case EBarrierPolicy::generation:     generation_arrive(); break;
+        case EBarrierPolicy::combining_tree: tree_arrive();       break;
+        default:                             turnstile_phase1();
+    }
+}
+
+void Barrier::phase2()
+{
+    switch (policy)
+    {
+        case EBarrierPolicy::generation:     generation_arrive(); break;
+        case EBarrierPolicy::combining_tree: tree_arrive();       break;
+        default:                             turnstile_phase2();
+    }
+}
+
+void Barrier::wait()
+{
+    if (policy != EBarrierPolicy::turnstile)
+    {
+        // The generation number already makes the barrier reusable, so one crossing is enough.
+        phase1();
+        return;
+    }
+
+    phase1();
+    phase2();
+}
+
+void Barrier::turnstile_phase1()
 {
     mutex.acquire(); // wait , lock
     count++; // counts the thread which gets in
     if (count == n) { turnstile.release(n); } // Allowe to pass whole threads
     mutex.release();
 
+    WaitForGraph::Waiting waiting(graphNode);
     turnstile.acquire();
 }
 
-void Barrier::phase2()
+void Barrier::turnstile_phase2()
 {
     mutex.acquire(); // wait , lock
     count--; // counts the thread which gets out
     if (count == 0) { turnstile2.release(n); } // Allowe to pass whole threads
     mutex.release();
 
+    WaitForGraph::Waiting waiting(graphNode);
     turnstile2.acquire();
 }
 
-void Barrier::wait()
+void Barrier::generation_arrive()
 {
-    phase1();
-    phase2();
-}
\ No newline at end of file
+    // fetch_add returns the word before our arrival, so we know our generation and our arrival order at once.
+    const uint32_t previous = state.fetch_add(1, std::memory_order_acq_rel);
+    const uint32_t generation = previous >> generationShift;
+
+    if (static_cast<int>((previous & arrivedMask) + 1) == n)
+    {
+        // Last thread : reset the counter and open the next generation for everybody.
+        state.store(((generation + 1) & arrivedMask) << generationShift, std::memory_order_release);
+        state.notify_all();
+        return;
+    }
+
+    await_generation_change(generation, generationShift);
+}
+
+void Barrier::build_tree()
+{
+    // Level 0 are the leaves (one per treeRadix threads), every next level combines treeRadix nodes of the previous one.
+    std::vector<int> levelWidths;
+    for (int width = n; width > 1 || levelWidths.empty(); )
+    {
+        width = (width + treeRadix - 1) / treeRadix;
+        levelWidths.push_back(width);
+    }
+
+    int total = 0;
+    for (int width : levelWidths) { total += width; }
+    tree = std::make_unique<TreeNode[]>(total);
+
+    int childrenBelow = n; // threads for the leaves, nodes for the upper levels
+    int offset = 0;
+    for (size_t level = 0; level < levelWidths.size(); ++level)
+    {
+        const int width = levelWidths[level];
+        const int parentOffset = offset + width;
+
+        for (int i = 0; i < width; ++i)
+        {
+            tree[offset + i].expected = std::min(treeRadix, childrenBelow - i * treeRadix);
+            tree[offset + i].parent = level + 1 < levelWidths.size() ? parentOffset + i / treeRadix : -1;
+        }
+
+        childrenBelow = width;
+        offset = parentOffset;
+    }
+}
+
+int Barrier::tree_slot()
+{
+    struct SlotCache
+    {
+        uint64_t barrierId;
+        int slot;
+    };
+
+    // A thread usually works with one or two barriers, so a linear scan is cheaper than a map.
+    static thread_local std::vector<SlotCache> cache;
+    for (const auto& entry : cache)
+    {
+        if (entry.barrierId == id) { return entry.slot; }
+    }
+
+    const int slot = registered.fetch_add(1, std::memory_order_relaxed);
+    // One slot more and the thread would arrive at a node above the leaves, or past the end of the tree.
+    if (slot >= n) { misuse("combining_tree barrier used by more than n different threads"); }
+    cache.push_back({id, slot});
+    return slot;
+}
+
+void Barrier::tree_arrive()
+{
+    // The generation cannot move before we arrive, so it is safe to read it first.
+    const uint32_t generation = state.load(std::memory_order_acquire);
+    int node = tree_slot() / treeRadix;
+
+    while (true)
+    {
+        TreeNode& current = tree[node];
+        if (current.arrived.fetch_add(1, std::memory_order_acq_rel) + 1 != current.expected)
+        {
+            break; // somebody else completes this node, we only wait
+        }
+
+        // Nobody else arrives at this node in this generation, so the reset cannot race.
+        current.arrived.store(0, std::memory_order_relaxed);
+
+        if (current.parent < 0)
+        {
+            state.store(generation + 1, std::memory_order_release);
+            state.notify_all();
+            return;
+        }
+        node = current.parent;
+    }
+
+    await_generation_change(generation, 0);
+}
+
+void Barrier::await_generation_change(uint32_t _generation, int _shift)
+{
+    WaitForGraph::Waiting waiting(graphNode);
+    uint32_t current = state.load(std::memory_order_acquire);
+    for (int i = 0; i < spinCount && (current >> _shift) == _generation; ++i)
+    {
+        cpu_relax();
+        current = state.load(std::memory_order_acquire);
+    }
+
+    // Other arrivals may change the word too, so keep sleeping until the generation itself has moved.
+    while ((current >> _shift) == _generation)
+    {
+        state.wait(current, std::memory_order_acquire);
+        current = state.load(std::memory_order_acquire);
+    }
+}
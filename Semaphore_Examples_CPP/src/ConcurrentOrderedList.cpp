@@ -0,0 +1,102 @@
+//
+// Created by agent on 10/17/2026.
+//
+
+#include "../include/ConcurrentOrderedList.h"
+#include "../include/EpochReclaimer.h"
+
+ConcurrentOrderedList::ConcurrentOrderedList() :
+        head(new Node(INT_MIN, new Node(INT_MAX))),
+        count(0)
+{
+}
+
+ConcurrentOrderedList::~ConcurrentOrderedList()
+{
+    Node* current = head;
+    while (current)
+    {
+        Node* next = current->next.load(std::memory_order_relaxed);
+        delete current;
+        current = next;
+    }
+}
+
+void ConcurrentOrderedList::find(int _value, Node*& _pred, Node*& _curr) const
+{
+    _pred = head;
+    _curr = _pred->next.load(std::memory_order_acquire);
+    while (_curr->value < _value)
+    {
+        _pred = _curr;
+        _curr = _curr->next.load(std::memory_order_acquire);
+    }
+}
+
+// Called with both nodes locked : nobody removed them and nobody put a node between them since find().
+bool ConcurrentOrderedList::validate(const Node* _pred, const Node* _curr)
+{
+    return !_pred->marked.load(std::memory_order_relaxed) && !_curr->marked.load(std::memory_order_relaxed)
+           && _pred->next.load(std::memory_order_relaxed) == _curr;
+}
+
+bool ConcurrentOrderedList::contains(int _value) const
+{
+    if (is_sentinel(_value)) { return false; } // find() would stop at the sentinel node and report it as stored
+    EpochReclaimer::Guard guard; // nodes we walk over are not freed until we leave
+    Node* pred;
+    Node* curr;
+    find(_value, pred, curr);
+    return curr->value == _value && !curr->marked.load(std::memory_order_acquire);
+}
+
+bool ConcurrentOrderedList::insert(int _value)
+{
+    if (is_sentinel(_value)) { return false; }
+    EpochReclaimer::Guard guard;
+    while (true)
+    {
+        Node* pred;
+        Node* curr;
+        find(_value, pred, curr);
+
+        // pred->value < curr->value : every thread locks the smaller value first, so nobody waits in a cycle.
+        std::lock_guard<NodeLock> predLock(pred->lock);
+        std::lock_guard<NodeLock> currLock(curr->lock);
+        if (!validate(pred, curr)) { continue; } // somebody changed this part of the list, search again
+
+        if (curr->value == _value) { return false; }
+
+        pred->next.store(new Node(_value, curr), std::memory_order_release);
+        count.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+}
+
+bool ConcurrentOrderedList::remove(int _value)
+{
+    if (is_sentinel(_value)) { return false; } // removing a sentinel would cut the list off
+    EpochReclaimer::Guard guard;
+    Node* removed = nullptr;
+    while (!removed)
+    {
+        Node* pred;
+        Node* curr;
+        find(_value, pred, curr);
+
+        std::lock_guard<NodeLock> predLock(pred->lock);
+        std::lock_guard<NodeLock> currLock(curr->lock);
+        if (!validate(pred, curr)) { continue; }
+
+        if (curr->value != _value) { return false; }
+
+        curr->marked.store(true, std::memory_order_release); // logical delete, contains() does not see it any more
+        pred->next.store(curr->next.load(std::memory_order_relaxed), std::memory_order_release); // physical delete
+        count.fetch_sub(1, std::memory_order_relaxed);
+        removed = curr;
+    }
+
+    // Unlinked and unlocked : only searchers which are already standing on it can still see it.
+    EpochReclaimer::instance().retire(removed);
+    return true;
+}
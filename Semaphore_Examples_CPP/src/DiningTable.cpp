@@ -0,0 +1,273 @@
+//
+// Created by agent on 10/17/2026.
+//
+
+#include "../include/DiningTable.h"
+#include "../include/scenario_runtime.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+namespace
+{
+    // Like Barrier.cpp : a bad table size is reported and stops the program in release builds as well.
+    [[noreturn]] void misuse(const char* _message)
+    {
+        std::fprintf(stderr, "DiningTable : %s\n", _message);
+        std::abort();
+    }
+}
+
+DiningTable::DiningTable(int _philosophers, EDiningStrategy _strategy) :
+        n(_philosophers),
+        policy(_strategy),
+        philosophers(std::make_unique<Philosopher[]>(_philosophers)),
+        forks(std::make_unique<Fork[]>(_philosophers)),
+        stateWords(std::make_unique<StateWord[]>((_philosophers + philosophersPerWord - 1) / philosophersPerWord)),
+        footman(_philosophers - 1)
+{
+    // With one philosopher both forks are the same : the footman never seats the philosopher, Chandy-Misra locks one fork twice.
+    if (n < 2) { misuse("a dining table needs two philosophers at least"); }
+
+    // Chandy-Misra : every fork starts dirty at the lower numbered of its two philosophers.
+    for (int i = 0; i < n; ++i) { forks[i].owner = std::min(i, right_neighbour(i)); }
+}
+
+bool DiningTable::get_forks(int _index, const std::stop_token& _token)
+{
+    const auto start = std::chrono::steady_clock::now();
+
+    bool success = false;
+    switch (policy)
+    {
+        case EDiningStrategy::footman:      success = footman_get_forks(_index, _token);      break;
+        case EDiningStrategy::tanenbaum:    success = tanenbaum_get_forks(_index, _token);    break;
+        case EDiningStrategy::tanenbaum_lock_free: success = lock_free_get_forks(_index, _token); break;
+        case EDiningStrategy::chandy_misra: success = chandy_misra_get_forks(_index, _token); break;
+    }
+    if (!success) { return false; }
+
+    // Only the thread which serves the philosopher writes its statistics, so no compare_exchange is needed.
+    Philosopher& philosopher = philosophers[_index];
+    const auto hunger = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+    if (hunger > philosopher.maxHungerNs.load(std::memory_order_relaxed)) { philosopher.maxHungerNs.store(hunger, std::memory_order_relaxed); }
+    return true;
+}
+
+void DiningTable::put_forks(int _index)
+{
+    philosophers[_index].meals.fetch_add(1, std::memory_order_relaxed);
+
+    switch (policy)
+    {
+        case EDiningStrategy::footman:      footman_put_forks(_index);      break;
+        case EDiningStrategy::tanenbaum:    tanenbaum_put_forks(_index);    break;
+        case EDiningStrategy::tanenbaum_lock_free: lock_free_put_forks(_index); break;
+        case EDiningStrategy::chandy_misra: chandy_misra_put_forks(_index); break;
+    }
+}
+
+uint64_t DiningTable::meals() const
+{
+    uint64_t total = 0;
+    for (int i = 0; i < n; ++i) { total += philosophers[i].meals.load(std::memory_order_relaxed); }
+    return total;
+}
+
+uint64_t DiningTable::max_hunger_nanoseconds() const
+{
+    uint64_t longest = 0;
+    for (int i = 0; i < n; ++i) { longest = std::max(longest, philosophers[i].maxHungerNs.load(std::memory_order_relaxed)); }
+    return longest;
+}
+
+bool DiningTable::footman_get_forks(int _index, const std::stop_token& _token)
+{
+    if (!scenario_runtime::acquire(footman, _token)) { return false; }
+    if (!scenario_runtime::acquire(forks[right_fork(_index)].sem, _token)) { return false; }
+    if (!scenario_runtime::acquire(forks[left_fork(_index)].sem, _token)) { return false; }
+    return true;
+}
+
+void DiningTable::footman_put_forks(int _index)
+{
+    forks[right_fork(_index)].sem.release();
+    forks[left_fork(_index)].sem.release();
+    footman.release();
+}
+
+bool DiningTable::tanenbaum_get_forks(int _index, const std::stop_token& _token)
+{
+    {
+        std::lock_guard<std::mutex> lock(tableMutex);
+        philosophers[_index].state = EState::hungry;
+        tanenbaum_test(_index);
+    }
+    return scenario_runtime::acquire(philosophers[_index].turn, _token);
+}
+
+void DiningTable::tanenbaum_put_forks(int _index)
+{
+    std::lock_guard<std::mutex> lock(tableMutex);
+    philosophers[_index].state = EState::thinking;
+    tanenbaum_test(right_neighbour(_index));
+    tanenbaum_test(left_neighbour(_index));
+}
+
+// A hungry philosopher whose neighbours do not eat may eat. Called under tableMutex.
+void DiningTable::tanenbaum_test(int _index)
+{
+    Philosopher& philosopher = philosophers[_index];
+    if (philosopher.state == EState::hungry
+        && philosophers[left_neighbour(_index)].state != EState::eating
+        && philosophers[right_neighbour(_index)].state != EState::eating)
+    {
+        philosopher.state = EState::eating;
+        philosopher.turn.release();
+    }
+}
+
+bool DiningTable::lock_free_get_forks(int _index, const std::stop_token& _token)
+{
+    word_of(_index).fetch_or(hungry_bit(_index), std::memory_order_seq_cst);
+    if (lock_free_try_eat(_index)) { return true; }
+    return scenario_runtime::acquire(philosophers[_index].turn, _token); // a neighbour lets us eat in put_forks
+}
+
+void DiningTable::lock_free_put_forks(int _index)
+{
+    std::atomic<uint32_t>& leftWord = word_of(left_fork(_index));
+    std::atomic<uint32_t>& rightWord = word_of(right_fork(_index));
+    if (&leftWord == &rightWord)
+    {
+        leftWord.fetch_and(~(fork_bit(left_fork(_index)) | fork_bit(right_fork(_index))), std::memory_order_seq_cst);
+    }
+    else
+    {
+        leftWord.fetch_and(~fork_bit(left_fork(_index)), std::memory_order_seq_cst);
+        rightWord.fetch_and(~fork_bit(right_fork(_index)), std::memory_order_seq_cst);
+    }
+
+    lock_free_test(right_neighbour(_index));
+    lock_free_test(left_neighbour(_index));
+}
+
+void DiningTable::lock_free_test(int _index)
+{
+    if (lock_free_try_eat(_index)) { philosophers[_index].turn.release(); }
+}
+
+// hungry -> eating for _index, by itself or by a neighbour. Only one of them can win, the forks are taken once.
+bool DiningTable::lock_free_try_eat(int _index)
+{
+    const int leftFork = left_fork(_index);
+    const int rightFork = right_fork(_index);
+    std::atomic<uint32_t>& leftWord = word_of(leftFork); // holds the hungry bit of _index as well
+    std::atomic<uint32_t>& rightWord = word_of(rightFork);
+    const uint32_t hungry = hungry_bit(_index);
+
+    if (&leftWord == &rightWord)
+    {
+        const uint32_t forkBits = fork_bit(leftFork) | fork_bit(rightFork);
+        uint32_t current = leftWord.load(std::memory_order_seq_cst);
+        while ((current & hungry) && !(current & forkBits))
+        {
+            if (leftWord.compare_exchange_weak(current, (current | forkBits) & ~hungry, std::memory_order_seq_cst)) { return true; }
+        }
+        return false;
+    }
+
+    while (true)
+    {
+        bool haveLeft = false;
+        uint32_t current = leftWord.load(std::memory_order_seq_cst);
+        while (!haveLeft && (current & hungry) && !(current & fork_bit(leftFork)))
+        {
+            haveLeft = leftWord.compare_exchange_weak(current, current | fork_bit(leftFork), std::memory_order_seq_cst);
+        }
+        if (!haveLeft) { return false; }
+
+        if (!(rightWord.fetch_or(fork_bit(rightFork), std::memory_order_seq_cst) & fork_bit(rightFork)))
+        {
+            leftWord.fetch_and(~hungry, std::memory_order_seq_cst);
+            return true;
+        }
+
+        // The right fork is in use : give the left one back. The left neighbour may have found it taken meanwhile.
+        leftWord.fetch_and(~fork_bit(leftFork), std::memory_order_seq_cst);
+        lock_free_test(left_neighbour(_index));
+
+        // Still in use : its holder tries us when it puts it down. Free now : its holder may have tried us while we
+        // held the left fork and failed, so nobody else will, try again.
+        if (rightWord.load(std::memory_order_seq_cst) & fork_bit(rightFork)) { return false; }
+    }
+}
+
+bool DiningTable::chandy_misra_get_forks(int _index, const std::stop_token& _token)
+{
+    Fork& left = forks[left_fork(_index)];
+    Fork& right = forks[right_fork(_index)];
+    // The lower numbered fork first, so two neighbours never lock their shared fork in different orders.
+    Fork& first = left_fork(_index) < right_fork(_index) ? left : right;
+    Fork& second = &first == &left ? right : left;
+    Philosopher& philosopher = philosophers[_index];
+
+    // Takes the fork if we may, otherwise asks its holder for it. Called under the mutex of the fork.
+    const auto claim = [this, _index](Fork& _fork, int _neighbour)
+    {
+        if (_fork.owner == _index) { return true; }
+        if (_fork.dirty && philosophers[_neighbour].state != EState::eating)
+        {
+            _fork.owner = _index;
+            _fork.dirty = false;
+            _fork.requested = false;
+            return true;
+        }
+        _fork.requested = true; // clean, or the neighbour eats : it hands the fork over in put_forks
+        return false;
+    };
+
+    while (true)
+    {
+        {
+            std::lock_guard<std::mutex> firstLock(first.mutex);
+            std::lock_guard<std::mutex> secondLock(second.mutex);
+            philosopher.state = EState::hungry;
+            const bool haveLeft = claim(left, left_neighbour(_index));
+            const bool haveRight = claim(right, right_neighbour(_index));
+            if (haveLeft && haveRight)
+            {
+                philosopher.state = EState::eating;
+                return true;
+            }
+        }
+        // A handed over fork releases our turn. A token may be left over from an earlier handover, then we look once more for nothing.
+        if (!scenario_runtime::acquire(philosopher.turn, _token)) { return false; }
+    }
+}
+
+void DiningTable::chandy_misra_put_forks(int _index)
+{
+    Fork& left = forks[left_fork(_index)];
+    Fork& right = forks[right_fork(_index)];
+    Fork& first = left_fork(_index) < right_fork(_index) ? left : right;
+    Fork& second = &first == &left ? right : left;
+
+    std::lock_guard<std::mutex> firstLock(first.mutex);
+    std::lock_guard<std::mutex> secondLock(second.mutex);
+    philosophers[_index].state = EState::thinking;
+
+    const auto hand_over = [this](Fork& _fork, int _neighbour)
+    {
+        _fork.dirty = true;
+        if (!_fork.requested) { return; }
+
+        _fork.owner = _neighbour;
+        _fork.dirty = false;
+        _fork.requested = false;
+        philosophers[_neighbour].turn.release();
+    };
+    hand_over(left, left_neighbour(_index));
+    hand_over(right, right_neighbour(_index));
+}
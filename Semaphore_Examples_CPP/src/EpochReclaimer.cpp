@@ -0,0 +1,103 @@
+//
+// Created by agent on 10/17/2026.
+//
+
+#include "../include/EpochReclaimer.h"
+#include <algorithm>
+
+struct EpochReclaimer::RecordOwner
+{
+    explicit RecordOwner(ThreadRecord& _record) : record(_record) {}
+    ~RecordOwner() { record.inUse.store(false, std::memory_order_release); } // its limbo goes to the next owner
+    ThreadRecord& record;
+};
+
+EpochReclaimer& EpochReclaimer::instance()
+{
+    static EpochReclaimer reclaimer;
+    return reclaimer;
+}
+
+EpochReclaimer::~EpochReclaimer()
+{
+    for (auto& record : records)
+    {
+        for (const Retired& retired : record->limbo) { retired.deleter(retired.object); }
+    }
+}
+
+EpochReclaimer::ThreadRecord& EpochReclaimer::thread_record()
+{
+    thread_local RecordOwner owner([this]() -> ThreadRecord&
+    {
+        std::lock_guard<std::mutex> lock(recordsMutex);
+        for (auto& record : records)
+        {
+            bool inUse = false;
+            if (record->inUse.compare_exchange_strong(inUse, true, std::memory_order_acquire)) { return *record; }
+        }
+        records.push_back(std::make_unique<ThreadRecord>());
+        return *records.back();
+    }());
+    return owner.record;
+}
+
+EpochReclaimer::Guard::Guard()
+{
+    ThreadRecord& record = instance().thread_record();
+    if (record.depth++ == 0)
+    {
+        record.epoch.store(instance().globalEpoch.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        // The pinned epoch must be visible before we read any pointer of the structure.
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+    }
+}
+
+EpochReclaimer::Guard::~Guard()
+{
+    ThreadRecord& record = instance().thread_record();
+    if (--record.depth == 0) { record.epoch.store(quiescent, std::memory_order_release); }
+}
+
+void EpochReclaimer::retire(void* _object, void (*_deleter)(void*))
+{
+    ThreadRecord& record = thread_record();
+    // The object is unlinked already, so the epoch read now is not older than the unlink.
+    record.limbo.push_back({globalEpoch.load(std::memory_order_seq_cst), _object, _deleter});
+
+    if (++record.retiresSinceScan >= scanInterval)
+    {
+        record.retiresSinceScan = 0;
+        try_advance();
+        free_expired(record);
+    }
+}
+
+// The epoch moves on only if every pinned thread has seen the current one.
+bool EpochReclaimer::try_advance()
+{
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    uint64_t epoch = globalEpoch.load(std::memory_order_seq_cst);
+    {
+        std::lock_guard<std::mutex> lock(recordsMutex);
+        for (const auto& record : records)
+        {
+            const uint64_t pinned = record->epoch.load(std::memory_order_seq_cst);
+            if (pinned != quiescent && pinned != epoch) { return false; }
+        }
+    }
+    return globalEpoch.compare_exchange_strong(epoch, epoch + 1, std::memory_order_seq_cst);
+}
+
+void EpochReclaimer::free_expired(ThreadRecord& _record)
+{
+    const uint64_t epoch = globalEpoch.load(std::memory_order_acquire);
+    const auto expired = std::partition(_record.limbo.begin(), _record.limbo.end(), [epoch](const Retired& _retired)
+    {
+        return _retired.epoch + 2 > epoch; // still in its grace period
+    });
+
+    for (auto it = expired; it != _record.limbo.end(); ++it) { it->deleter(it->object); }
+    freedCount.fetch_add(static_cast<uint64_t>(_record.limbo.end() - expired), std::memory_order_relaxed);
+    _record.limbo.erase(expired, _record.limbo.end());
+}
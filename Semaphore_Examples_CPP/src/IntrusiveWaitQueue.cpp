@@ -0,0 +1,35 @@
+//
+// Created by agent on 10/17/2026.
+//
+
+#include "../include/IntrusiveWaitQueue.h"
+#include <array>
+#include <deque>
+#include <mutex>
+
+namespace
+{
+    struct ThreadNodes
+    {
+        std::array<IntrusiveWaitQueue::Node, IntrusiveWaitQueue::nodesPerThread> nodes;
+    };
+
+    // A deque never moves its elements, the nodes keep their addresses until the end of the program.
+    std::mutex poolMutex;
+    std::deque<ThreadNodes> pool;
+
+    ThreadNodes& allocate_thread_nodes()
+    {
+        std::lock_guard<std::mutex> lock(poolMutex);
+        return pool.emplace_back();
+    }
+}
+
+IntrusiveWaitQueue::Node& IntrusiveWaitQueue::this_thread_node(int _slot)
+{
+    assert(_slot >= 0 && _slot < nodesPerThread && "only nodesPerThread nodes per thread");
+
+    // One allocation per thread, at its first wait.
+    thread_local ThreadNodes& mine = allocate_thread_nodes();
+    return mine.nodes[_slot];
+}
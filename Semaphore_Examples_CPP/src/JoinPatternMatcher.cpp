@@ -0,0 +1,115 @@
+//
+// Created by agent on 10/17/2026.
+//
+
+#include "../include/JoinPatternMatcher.h"
+#include "../include/scenario_runtime.h"
+#include <algorithm>
+#include <bit>
+#include <cstdio>
+#include <cstdlib>
+
+namespace
+{
+    // A bad resource index would read past recipesOf, so it stops the program, not only in debug builds.
+    [[noreturn]] void misuse(const char* _message)
+    {
+        std::fprintf(stderr, "JoinPatternMatcher : %s\n", _message);
+        std::abort();
+    }
+}
+
+JoinPatternMatcher::JoinPatternMatcher(int _resourceTypes) :
+        resourceTypes(_resourceTypes),
+        counters(std::make_unique<Counter[]>(_resourceTypes)),
+        recipesOf(_resourceTypes)
+{
+    if (_resourceTypes <= 0 || _resourceTypes > maxResources) { misuse("a matcher takes 1 to 64 resource types, a recipe mask has 64 bits"); }
+}
+
+int JoinPatternMatcher::add_recipe(Mask _resources)
+{
+    if (_resources == 0) { misuse("a recipe needs at least one resource"); }
+    // A bit past resourceTypes would index recipesOf out of its bounds.
+    if (resourceTypes != maxResources && _resources >> resourceTypes != 0) { misuse("unknown resource in the recipe"); }
+
+    recipes.push_back(std::make_unique<Recipe>(_resources));
+    for (Mask rest = _resources; rest != 0; rest &= rest - 1)
+    {
+        recipesOf[std::countr_zero(rest)].push_back(recipes.back().get());
+    }
+    return static_cast<int>(recipes.size()) - 1;
+}
+
+void JoinPatternMatcher::produce(int _resource, int64_t _count)
+{
+    counters[_resource].count.fetch_add(_count, std::memory_order_seq_cst);
+
+    // Pairs with consume : either the waiter sees the new units in its last try, or we see the waiter.
+    for (Recipe* recipe : recipesOf[_resource])
+    {
+        const int waiters = recipe->waiters.load(std::memory_order_seq_cst);
+        if (waiters > 0) { recipe->wakeups.release(std::min<int64_t>(waiters, _count)); }
+    }
+}
+
+bool JoinPatternMatcher::take_one(int _resource)
+{
+    std::atomic<int64_t>& count = counters[_resource].count;
+    int64_t current = count.load(std::memory_order_relaxed);
+    while (current > 0)
+    {
+        if (count.compare_exchange_weak(current, current - 1, std::memory_order_seq_cst, std::memory_order_relaxed)) { return true; }
+    }
+    return false;
+}
+
+void JoinPatternMatcher::give_back(Mask _taken)
+{
+    // Somebody may have found these units gone for a moment and gone to sleep, so they are produced again.
+    for (Mask rest = _taken; rest != 0; rest &= rest - 1) { produce(std::countr_zero(rest)); }
+}
+
+bool JoinPatternMatcher::try_consume(int _recipe)
+{
+    const Mask resources = recipes[_recipe]->resources;
+
+    // Cheap check first, so a recipe which cannot be served does not take and give back units. Sequentially
+    // consistent, it is the "last try" of a registered waiter.
+    for (Mask rest = resources; rest != 0; rest &= rest - 1)
+    {
+        if (counters[std::countr_zero(rest)].count.load(std::memory_order_seq_cst) <= 0) { return false; }
+    }
+
+    Mask taken = 0;
+    for (Mask rest = resources; rest != 0; rest &= rest - 1)
+    {
+        const int resource = std::countr_zero(rest);
+        if (!take_one(resource))
+        {
+            give_back(taken);
+            return false;
+        }
+        taken |= mask_of(resource);
+    }
+    return true;
+}
+
+bool JoinPatternMatcher::consume(int _recipe, const std::stop_token& _token)
+{
+    Recipe& recipe = *recipes[_recipe];
+    while (!try_consume(_recipe))
+    {
+        recipe.waiters.fetch_add(1, std::memory_order_seq_cst);
+        if (try_consume(_recipe))
+        {
+            recipe.waiters.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+
+        const bool wokenUp = scenario_runtime::acquire(recipe.wakeups, _token);
+        recipe.waiters.fetch_sub(1, std::memory_order_relaxed);
+        if (!wokenUp) { return false; }
+    }
+    return true;
+}
@@ -0,0 +1,181 @@
+//
+// Created by agent on 10/17/2026.
+//
+
+#include "../include/LogSink.h"
+#include <chrono>
+#include <cstdio>
+
+struct LogSink::RingOwner
+{
+    explicit RingOwner(ThreadRing& _ring) : ring(_ring) {}
+    ~RingOwner() { ring.retired.store(true, std::memory_order_release); }
+    ThreadRing& ring;
+};
+
+LogSink& LogSink::instance()
+{
+    static LogSink sink;
+    return sink;
+}
+
+LogSink::LogSink() : drainThread(&LogSink::drain_loop, this) {}
+
+LogSink::~LogSink()
+{
+    stopping.store(true, std::memory_order_seq_cst);
+    wake_drain();
+    if (drainThread.joinable()) { drainThread.join(); }
+}
+
+LogSink::ThreadRing& LogSink::thread_ring()
+{
+    thread_local RingOwner owner([this]() -> ThreadRing&
+    {
+        std::lock_guard<std::mutex> lock(ringsMutex);
+        rings.push_back(std::make_unique<ThreadRing>());
+        return *rings.back();
+    }());
+    return owner.ring;
+}
+
+void LogSink::write(std::string_view _line)
+{
+    ThreadRing& ring = thread_ring();
+    const uint64_t tail = ring.tail.load(std::memory_order_relaxed);
+
+    // Ring is full : give the drain thread the time slice, it may need this core to empty the ring.
+    while (tail - ring.head.load(std::memory_order_acquire) == ringCapacity) { std::this_thread::yield(); }
+
+    Record& record = ring.records[tail & (ringCapacity - 1)];
+    record.length = static_cast<uint32_t>(std::min(_line.size(), lineCapacity));
+    _line.copy(record.text, record.length);
+    // The stamp is taken as late as possible, so it reflects the order in which the lines were finished.
+    record.stamp = static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+
+    // Pairs with drain_loop : either the drain sees this line before it sleeps, or we see that it sleeps.
+    ring.tail.store(tail + 1, std::memory_order_seq_cst);
+    if (drainSleeping.load(std::memory_order_seq_cst)) { wake_drain(); }
+}
+
+void LogSink::wake_drain()
+{
+    wakeups.fetch_add(1, std::memory_order_seq_cst);
+    wakeups.notify_one();
+}
+
+void LogSink::flush()
+{
+    // Every line written so far : the ones in the rings and the ones of the rings which are gone already.
+    uint64_t target = 0;
+    {
+        std::lock_guard<std::mutex> lock(ringsMutex);
+        target = removedLines;
+        for (const auto& ring : rings) { target += ring->tail.load(std::memory_order_acquire); }
+    }
+
+    std::unique_lock<std::mutex> lock(flushMutex);
+    flushed.wait(lock, [&] { return printedLines.load(std::memory_order_acquire) >= target; });
+}
+
+std::vector<LogSink::ThreadRing*> LogSink::live_rings()
+{
+    std::vector<ThreadRing*> snapshot;
+    std::lock_guard<std::mutex> lock(ringsMutex);
+    // A retired ring gets no new lines, so it can go once it is empty.
+    std::erase_if(rings, [this](const std::unique_ptr<ThreadRing>& _ring)
+    {
+        const uint64_t tail = _ring->tail.load(std::memory_order_acquire);
+        if (!_ring->retired.load(std::memory_order_acquire) || _ring->head.load(std::memory_order_relaxed) != tail) { return false; }
+        removedLines += tail;
+        return true;
+    });
+    for (const auto& ring : rings) { snapshot.push_back(ring.get()); }
+    return snapshot;
+}
+
+bool LogSink::all_rings_empty()
+{
+    std::lock_guard<std::mutex> lock(ringsMutex);
+    for (const auto& ring : rings)
+    {
+        if (ring->head.load(std::memory_order_relaxed) != ring->tail.load(std::memory_order_seq_cst)) { return false; }
+    }
+    return true;
+}
+
+uint64_t LogSink::drain_available(std::string& _out)
+{
+    const std::vector<ThreadRing*> snapshot = live_rings();
+
+    // Tails are read once per round, lines published meanwhile wait for the next round.
+    std::vector<uint64_t> heads(snapshot.size());
+    std::vector<uint64_t> tails(snapshot.size());
+    for (size_t i = 0; i < snapshot.size(); ++i)
+    {
+        heads[i] = snapshot[i]->head.load(std::memory_order_relaxed);
+        tails[i] = snapshot[i]->tail.load(std::memory_order_acquire);
+    }
+
+    // Merge : the lines of a ring are in stamp order, so the next line is the head with the smallest stamp.
+    uint64_t printed = 0;
+    while (true)
+    {
+        size_t next = snapshot.size();
+        for (size_t i = 0; i < snapshot.size(); ++i)
+        {
+            if (heads[i] == tails[i]) { continue; }
+            if (next == snapshot.size()
+                || snapshot[i]->records[heads[i] & (ringCapacity - 1)].stamp < snapshot[next]->records[heads[next] & (ringCapacity - 1)].stamp)
+            {
+                next = i;
+            }
+        }
+        if (next == snapshot.size()) { break; }
+
+        const Record& record = snapshot[next]->records[heads[next] & (ringCapacity - 1)];
+        _out.append(record.text, record.length);
+        _out.push_back('\n');
+        ++heads[next];
+        ++printed;
+    }
+
+    for (size_t i = 0; i < snapshot.size(); ++i) { snapshot[i]->head.store(heads[i], std::memory_order_release); }
+    return printed;
+}
+
+void LogSink::drain_loop()
+{
+    std::string out;
+    uint64_t written = 0; // lines handed to fwrite, but not fflush'ed yet
+    while (true)
+    {
+        const uint64_t drained = drain_available(out);
+        if (!out.empty())
+        {
+            std::fwrite(out.data(), 1, out.size(), stdout);
+            out.clear();
+        }
+        written += drained;
+        if (drained > 0) { continue; }
+
+        // Lines count as printed only once they left the stdio buffer, flush() waiters rely on it.
+        std::fflush(stdout);
+        {
+            std::lock_guard<std::mutex> lock(flushMutex);
+            printedLines.fetch_add(written, std::memory_order_release);
+        }
+        written = 0;
+        flushed.notify_all();
+
+        // Nothing to print : sleep until a writer publishes a line (or the sink is destroyed).
+        const uint32_t seen = wakeups.load(std::memory_order_seq_cst);
+        drainSleeping.store(true, std::memory_order_seq_cst);
+        if (all_rings_empty())
+        {
+            if (stopping.load(std::memory_order_seq_cst)) { return; }
+            wakeups.wait(seen, std::memory_order_seq_cst);
+        }
+        drainSleeping.store(false, std::memory_order_relaxed);
+    }
+}
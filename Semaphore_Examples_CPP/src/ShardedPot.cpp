@@ -0,0 +1,112 @@
+//
+// Created by agent on 10/17/2026.
+//
+
+#include "../include/ShardedPot.h"
+#include "../include/scenario_runtime.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+
+namespace
+{
+    // A kitchen which cannot work (no pot for a cook, a watermark never crossed) stops the program in every build.
+    [[noreturn]] void misuse(const char* _message)
+    {
+        std::fprintf(stderr, "ShardedPot : %s\n", _message);
+        std::abort();
+    }
+}
+
+ShardedPot::ShardedPot(int _pots, int _cooks, int _servingsPerRefill, int _lowWatermark) :
+        potCount(_pots),
+        cookCount(_cooks),
+        servingsPerRefill(_servingsPerRefill),
+        lowWatermark(_lowWatermark),
+        pot(std::make_unique<Pot[]>(_pots)),
+        cook(std::make_unique<Cook[]>(_cooks))
+{
+    if (_pots <= 0 || _cooks <= 0 || _cooks > _pots) { misuse("every cook needs a pot (0 < cooks <= pots)"); }
+    // A watermark at or above a full pot is never crossed by a serving, the orders stop matching the refills and
+    // next_order scans forever.
+    if (_lowWatermark < 0 || _lowWatermark >= _servingsPerRefill) { misuse("a refill must lift the pot above the watermark (0 <= watermark < servings per refill)"); }
+
+    // The pots start full, the first orders come at the watermark.
+    for (int i = 0; i < potCount; ++i) { pot[i].servings.store(servingsPerRefill, std::memory_order_relaxed); }
+}
+
+bool ShardedPot::take_from(int _pot)
+{
+    std::atomic<int64_t>& servings = pot[_pot].servings;
+    int64_t current = servings.load(std::memory_order_relaxed);
+    while (current > 0)
+    {
+        if (servings.compare_exchange_weak(current, current - 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+        {
+            if (current - 1 == lowWatermark)
+            {
+                pot[_pot].ordered.store(true, std::memory_order_release);
+                cook[_pot % cookCount].orders.release();
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
+int ShardedPot::take_from_any(int _home)
+{
+    for (int i = 0; i < potCount; ++i)
+    {
+        const int p = (_home + i) % potCount;
+        if (take_from(p)) { return p; }
+    }
+    return -1;
+}
+
+int ShardedPot::get_serving(int _savage, const std::stop_token& _token)
+{
+    const int home = _savage % potCount;
+    int p = take_from_any(home);
+    while (p < 0)
+    {
+        // Registered before the last try : either the cook sees us after its refill or we see the refill.
+        hungry.fetch_add(1, std::memory_order_seq_cst);
+        p = take_from_any(home);
+        if (p >= 0)
+        {
+            hungry.fetch_sub(1, std::memory_order_relaxed);
+            return p;
+        }
+
+        emptyWaits.fetch_add(1, std::memory_order_relaxed);
+        const bool woken = scenario_runtime::acquire(served, _token);
+        hungry.fetch_sub(1, std::memory_order_relaxed);
+        if (!woken) { return -1; }
+        p = take_from_any(home);
+    }
+    return p;
+}
+
+int ShardedPot::next_order(int _cook, const std::stop_token& _token)
+{
+    if (!scenario_runtime::acquire(cook[_cook].orders, _token)) { return -1; }
+
+    // Every order sets its flag before it releases the cook, so one of our pots is flagged.
+    while (true)
+    {
+        for (int p = _cook; p < potCount; p += cookCount)
+        {
+            if (pot[p].ordered.exchange(false, std::memory_order_acquire)) { return p; }
+        }
+    }
+}
+
+void ShardedPot::refill(int _pot)
+{
+    pot[_pot].servings.fetch_add(servingsPerRefill, std::memory_order_seq_cst);
+    refillCount.fetch_add(1, std::memory_order_relaxed);
+
+    const int waiting = hungry.load(std::memory_order_seq_cst);
+    if (waiting > 0) { served.release(std::min<int64_t>(waiting, servingsPerRefill)); }
+}
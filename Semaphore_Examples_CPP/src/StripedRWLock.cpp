@@ -0,0 +1,77 @@
+//
+// Created by agent on 10/17/2026.
+//
+
+#include "../include/StripedRWLock.h"
+#include "../include/spin_wait.h"
+#include <algorithm>
+#include <thread>
+
+namespace
+{
+    std::atomic<size_t> nextStripeIndex{0};
+
+    size_t stripe_count()
+    {
+        const size_t cores = std::max(std::thread::hardware_concurrency(), 1u);
+        size_t count = 1;
+        while (count < cores) { count <<= 1; }
+        return count;
+    }
+}
+
+StripedRWLock::StripedRWLock() :
+        mask(stripe_count() - 1),
+        stripes(std::make_unique<Stripe[]>(mask + 1)),
+        writerActive(false)
+{
+}
+
+// Threads get their stripes round-robin, the first time they read any StripedRWLock.
+size_t StripedRWLock::stripe_index_of_this_thread()
+{
+    thread_local const size_t index = nextStripeIndex.fetch_add(1, std::memory_order_relaxed);
+    return index;
+}
+
+void StripedRWLock::lock_shared()
+{
+    std::atomic<int>& readers = stripes[stripe_index_of_this_thread() & mask].readers;
+
+    while (true)
+    {
+        readers.fetch_add(1, std::memory_order_seq_cst);
+        if (!writerActive.load(std::memory_order_seq_cst)) { return; }
+
+        // A writer is in or waiting for the readers to leave, step back and sleep until it is done.
+        readers.fetch_sub(1, std::memory_order_release);
+        writerActive.wait(true, std::memory_order_acquire);
+    }
+}
+
+void StripedRWLock::unlock_shared()
+{
+    stripes[stripe_index_of_this_thread() & mask].readers.fetch_sub(1, std::memory_order_release);
+}
+
+void StripedRWLock::lock()
+{
+    writerMutex.lock();
+    writerActive.store(true, std::memory_order_seq_cst);
+
+    for (size_t i = 0; i <= mask; ++i)
+    {
+        for (int spin = 0; stripes[i].readers.load(std::memory_order_seq_cst) != 0; ++spin)
+        {
+            if (spin < spinCount) { cpu_relax(); }
+            else { std::this_thread::yield(); }
+        }
+    }
+}
+
+void StripedRWLock::unlock()
+{
+    writerActive.store(false, std::memory_order_release);
+    writerActive.notify_all();
+    writerMutex.unlock();
+}
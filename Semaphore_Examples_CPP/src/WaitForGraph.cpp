@@ -0,0 +1,273 @@
+//
+// Created by agent on 10/17/2026.
+//
+
+#include "../include/WaitForGraph.h"
+#include <algorithm>
+#include <condition_variable>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+namespace
+{
+    int64_t now_ns()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    // What the watchdog read from one record. The thread keeps running, so the snapshot may be a little stale.
+    struct ThreadSnapshot
+    {
+        int id;
+        const char* name;
+        const WaitForGraph::Primitive* waitingOn;
+        int64_t waitedMs;
+        std::vector<const WaitForGraph::Primitive*> held;
+    };
+
+    // Record is the private WaitForGraph::ThreadRecord.
+    template <typename Record>
+    ThreadSnapshot snapshot(const Record& _record, int64_t _now)
+    {
+        ThreadSnapshot thread{_record.id, _record.name, _record.waitingOn.load(std::memory_order_acquire), 0, {}};
+        if (thread.waitingOn)
+        {
+            thread.waitedMs = std::max<int64_t>(0, _now - _record.waitingSince.load(std::memory_order_relaxed)) / 1'000'000;
+        }
+        for (const auto& slot : _record.held)
+        {
+            if (const WaitForGraph::Primitive* primitive = slot.load(std::memory_order_acquire)) { thread.held.push_back(primitive); }
+        }
+        return thread;
+    }
+
+    void print_thread(std::ostream& _out, const ThreadSnapshot& _thread)
+    {
+        _out << "  thread " << _thread.id;
+        if (_thread.name) { _out << " (" << _thread.name << ")"; }
+
+        if (_thread.waitingOn) { _out << " waits on '" << _thread.waitingOn->name << "' for " << _thread.waitedMs << " ms"; }
+        else { _out << " runs"; }
+
+        if (!_thread.held.empty())
+        {
+            _out << ", holds";
+            for (const WaitForGraph::Primitive* primitive : _thread.held) { _out << " '" << primitive->name << "'"; }
+        }
+        _out << std::endl;
+    }
+}
+
+struct WaitForGraph::RecordOwner
+{
+    RecordOwner()
+    {
+        WaitForGraph& graph = instance();
+        std::lock_guard<std::mutex> lock(graph.recordsMutex);
+        record.id = graph.nextThreadId++;
+        graph.records.push_back(&record);
+    }
+
+    ~RecordOwner()
+    {
+        WaitForGraph& graph = instance();
+        std::lock_guard<std::mutex> lock(graph.recordsMutex);
+        graph.records.erase(std::remove(graph.records.begin(), graph.records.end(), &record), graph.records.end());
+    }
+
+    ThreadRecord record;
+};
+
+WaitForGraph& WaitForGraph::instance()
+{
+    static WaitForGraph graph;
+    return graph;
+}
+
+WaitForGraph::ThreadRecord& WaitForGraph::thread_record()
+{
+    thread_local RecordOwner owner;
+    return owner.record;
+}
+
+void WaitForGraph::set_thread_name(const char* _name)
+{
+    ThreadRecord& record = thread_record();
+    std::lock_guard<std::mutex> lock(recordsMutex); // the watchdog reads the name under the same mutex
+    record.name = _name;
+}
+
+void WaitForGraph::begin_wait(const Primitive& _primitive)
+{
+    ThreadRecord& record = thread_record();
+    if (record.waitingOn.load(std::memory_order_relaxed) == &_primitive) { return; } // the same wait goes on
+
+    record.waitingSince.store(now_ns(), std::memory_order_relaxed);
+    record.waitingOn.store(&_primitive, std::memory_order_release);
+}
+
+void WaitForGraph::end_wait()
+{
+    ThreadRecord& record = thread_record();
+    if (record.waitingOn.load(std::memory_order_relaxed) != nullptr) { record.waitingOn.store(nullptr, std::memory_order_release); }
+}
+
+void WaitForGraph::acquired(const Primitive& _primitive)
+{
+    ThreadRecord& record = thread_record();
+    end_wait();
+    for (auto& slot : record.held)
+    {
+        if (slot.load(std::memory_order_relaxed) == nullptr)
+        {
+            slot.store(&_primitive, std::memory_order_release);
+            return;
+        }
+    }
+}
+
+void WaitForGraph::released(const Primitive& _primitive)
+{
+    ThreadRecord& record = thread_record();
+    for (auto& slot : record.held)
+    {
+        if (slot.load(std::memory_order_relaxed) == &_primitive)
+        {
+            slot.store(nullptr, std::memory_order_release);
+            return;
+        }
+    }
+}
+
+void WaitForGraph::start_watchdog(WatchdogOptions _options)
+{
+    stop_watchdog();
+    tracking.store(true, std::memory_order_relaxed);
+    watchdog = std::jthread([this, _options](std::stop_token _token) { watch(_token, _options); });
+}
+
+void WaitForGraph::stop_watchdog()
+{
+    if (watchdog.joinable())
+    {
+        watchdog.request_stop();
+        watchdog.join();
+    }
+}
+
+void WaitForGraph::watch(std::stop_token _token, WatchdogOptions _options)
+{
+    std::ostream& out = _options.out ? *_options.out : std::cerr;
+    std::string lastReport; // a deadlock stays the same deadlock, report it once
+
+    std::mutex sleepMutex;
+    std::condition_variable_any sleep;
+    while (!_token.stop_requested())
+    {
+        {
+            std::unique_lock<std::mutex> lock(sleepMutex);
+            sleep.wait_for(lock, _token, _options.period, [] { return false; });
+        }
+        if (_token.stop_requested()) { break; }
+
+        std::ostringstream report;
+        if (!check(report, _options.stallThreshold))
+        {
+            lastReport.clear();
+            continue;
+        }
+
+        // The wait times grow on every scan, compare the report without them.
+        std::string shape = report.str();
+        for (size_t at = shape.find(" for "); at != std::string::npos; at = shape.find(" for ", at + 1))
+        {
+            shape.erase(at, shape.find(" ms", at) - at);
+        }
+        if (shape == lastReport) { continue; }
+
+        lastReport = shape;
+        out << report.str() << std::flush;
+    }
+}
+
+bool WaitForGraph::check(std::ostream& _out, std::chrono::milliseconds _stallThreshold)
+{
+    const int64_t now = now_ns();
+
+    std::vector<ThreadSnapshot> threads;
+    {
+        std::lock_guard<std::mutex> lock(recordsMutex);
+        for (const ThreadRecord* record : records) { threads.push_back(snapshot(*record, now)); }
+    }
+    if (threads.empty()) { return false; }
+
+    // Edge i -> j : thread i waits on an owned primitive which thread j holds.
+    const auto holder_of = [&threads](const Primitive* _primitive) -> int
+    {
+        for (size_t j = 0; j < threads.size(); ++j)
+        {
+            if (std::find(threads[j].held.begin(), threads[j].held.end(), _primitive) != threads[j].held.end()) { return static_cast<int>(j); }
+        }
+        return -1;
+    };
+
+    std::vector<int> next(threads.size(), -1); // a primitive has one holder, so every thread has one edge at most
+    for (size_t i = 0; i < threads.size(); ++i)
+    {
+        if (threads[i].waitingOn && threads[i].waitingOn->owned) { next[i] = holder_of(threads[i].waitingOn); }
+    }
+
+    // Follow the edges from every thread, a path which comes back to a thread on it is a cycle.
+    std::vector<int> cycle;
+    std::vector<int> visitedFrom(threads.size(), -1);
+    for (size_t start = 0; start < threads.size() && cycle.empty(); ++start)
+    {
+        int current = static_cast<int>(start);
+        while (current >= 0 && visitedFrom[current] < 0)
+        {
+            visitedFrom[current] = static_cast<int>(start);
+            current = next[current];
+        }
+        if (current >= 0 && visitedFrom[current] == static_cast<int>(start))
+        {
+            int member = current;
+            do
+            {
+                cycle.push_back(member);
+                member = next[member];
+            } while (member != current);
+        }
+    }
+
+    const bool stalled = std::all_of(threads.begin(), threads.end(), [&_stallThreshold](const ThreadSnapshot& _thread)
+    {
+        return _thread.waitingOn && _thread.waitedMs >= _stallThreshold.count();
+    });
+
+    if (cycle.empty() && !stalled) { return false; }
+
+    _out << "WAIT-FOR GRAPH : ";
+    if (!cycle.empty()) { _out << "deadlock cycle"; }
+    if (!cycle.empty() && stalled) { _out << ", "; }
+    if (stalled) { _out << "global stall (every tracked thread blocked for more than " << _stallThreshold.count() << " ms)"; }
+    _out << std::endl;
+
+    for (const ThreadSnapshot& thread : threads) { print_thread(_out, thread); }
+
+    if (!cycle.empty())
+    {
+        _out << "  cycle :";
+        for (int member : cycle) { _out << " thread " << threads[member].id << " -> '" << threads[member].waitingOn->name << "' ->"; }
+        _out << " thread " << threads[cycle.front()].id << std::endl;
+    }
+    return true;
+}
+
+void WaitForGraph::dump(std::ostream& _out)
+{
+    std::lock_guard<std::mutex> lock(recordsMutex);
+    const int64_t now = now_ns();
+    _out << "WAIT-FOR GRAPH : " << records.size() << " tracked threads" << std::endl;
+    for (const ThreadRecord* record : records) { print_thread(_out, snapshot(*record, now)); }
+}
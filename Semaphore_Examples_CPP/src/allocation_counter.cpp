@@ -0,0 +1,41 @@
+//
+// Created by agent on 10/17/2026.
+//
+
+#include "../include/allocation_counter.h"
+#include <cstdlib>
+#include <new>
+
+#if COUNT_ALLOCATIONS
+
+namespace
+{
+    // Plain integer : no dynamic initialization, so it is safe even for allocations made before main().
+    thread_local uint64_t threadAllocations = 0;
+}
+
+uint64_t allocation_counter::thread_allocations() { return threadAllocations; }
+
+void* operator new(std::size_t _size)
+{
+    ++threadAllocations;
+    if (_size == 0) { _size = 1; }
+
+    while (true)
+    {
+        if (void* memory = std::malloc(_size)) { return memory; }
+
+        std::new_handler handler = std::get_new_handler();
+        if (!handler) { throw std::bad_alloc(); }
+        handler();
+    }
+}
+
+void operator delete(void* _memory) noexcept { std::free(_memory); }
+void operator delete(void* _memory, std::size_t) noexcept { std::free(_memory); }
+
+#else
+
+uint64_t allocation_counter::thread_allocations() { return 0; }
+
+#endif